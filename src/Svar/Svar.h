@@ -56,14 +56,20 @@
 #include <sstream>
 #include <vector>
 #include <list>
+#include <deque>
 #include <set>
 #include <map>
 #include <array>
 #include <unordered_map>
+#include <unordered_set>
+#include <tuple>
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <thread>
+#include <chrono>
 #include <typeindex>
 #include <functional>
 
@@ -88,9 +94,22 @@
 typedef SSIZE_T ssize_t;
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64) // SSE2 is part of x86-64
+#include <emmintrin.h>
+#define SVAR_SCAN_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define SVAR_SCAN_AVX2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 #define svar sv::Svar::instance()
-#define SVAR_VERSION 0x000302
-#define EXPORT_SVAR_INSTANCE extern "C" SVAR_EXPORT sv::Svar* svarInstance(){return &sv::Svar::instance();}
+#define SVAR_VERSION 0x000400
+#define EXPORT_SVAR_INSTANCE extern "C" SVAR_EXPORT sv::Svar* svarInstance(){return &sv::Svar::instance();}\
+    extern "C" SVAR_EXPORT int svarVersion(){return SVAR_VERSION;}
 #define REGISTER_SVAR_MODULE(MODULE_NAME) \
     class SVAR_MODULE_##MODULE_NAME{\
     public: SVAR_MODULE_##MODULE_NAME();\
@@ -111,6 +130,7 @@ template <bool B, typename T = void> using enable_if_t = typename std::enable_if
 template <bool B, typename T, typename F> using conditional_t = typename std::conditional<B, T, F>::type;
 template <typename T> using remove_cv_t = typename std::remove_cv<T>::type;
 template <typename T> using remove_reference_t = typename std::remove_reference<T>::type;
+template <typename T> using decay_t = typename std::decay<T>::type;
 
 
 /// Strip the class from a method type
@@ -184,6 +204,696 @@ struct is_callable<TRet(*)(TArgs...)>{
 const static bool value = true;
 };
 
+/// Allocation statistics of the value nodes, see SvarArena::stats.
+/// Counters are kept per thread and summed when read, so counting costs no atomic operation.
+struct alloc_stats{
+    struct counters{
+        std::atomic<size_t> pool_allocs{0},pool_frees{0},arena_allocs{0},heap_allocs{0};
+        counters*           next=nullptr;
+        bool                retired=false;
+    };
+
+    enum event{pool_alloc,pool_free,arena_alloc,heap_alloc};
+
+    static void count(event e){
+        counters& c=local();
+        std::atomic<size_t>& v=e==pool_alloc?c.pool_allocs:e==pool_free?c.pool_frees:
+                               e==arena_alloc?c.arena_allocs:c.heap_allocs;
+        v.store(v.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+    }
+
+    static std::atomic<size_t>& pool_bytes(){static std::atomic<size_t> v(0);return v;}
+    static std::atomic<size_t>& arena_bytes(){static std::atomic<size_t> v(0);return v;}
+    static std::atomic<size_t>& arena_regions(){static std::atomic<size_t> v(0);return v;}
+
+    /// Sum the counters of all threads, the threads exited are included
+    static void sum(size_t& pool_allocs,size_t& pool_frees,size_t& arena_allocs,size_t& heap_allocs){
+        registry& r=global();
+        std::unique_lock<std::mutex> lock(r.mutex);
+        pool_allocs=pool_frees=arena_allocs=heap_allocs=0;
+        for(counters* c=r.head;c;c=c->next){
+            pool_allocs +=c->pool_allocs.load(std::memory_order_relaxed);
+            pool_frees  +=c->pool_frees.load(std::memory_order_relaxed);
+            arena_allocs+=c->arena_allocs.load(std::memory_order_relaxed);
+            heap_allocs +=c->heap_allocs.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct registry{
+        std::mutex mutex;
+        counters*  head=nullptr;
+    };
+
+    // hands the counters back for reuse when the thread exits, the values are kept
+    struct owner{
+        counters* c;
+        ~owner(){
+            std::unique_lock<std::mutex> lock(global().mutex);
+            c->retired=true;
+        }
+    };
+
+    static registry& global(){
+        static registry* r=new registry();// never destroyed, nodes may be freed after exit
+        return *r;
+    }
+
+    static counters& local(){
+        static thread_local counters* c=enroll();
+        return *c;
+    }
+
+    static counters* enroll(){
+        counters* c=nullptr;
+        {
+            registry& r=global();
+            std::unique_lock<std::mutex> lock(r.mutex);
+            for(counters* it=r.head;it;it=it->next)
+                if(it->retired) {c=it;break;}
+            if(c) c->retired=false;
+            else{
+                c=new counters();
+                c->next=r.head;
+                r.head=c;
+            }
+        }
+        static thread_local owner o={c};
+        return o.c;
+    }
+};
+
+/// Fixed size block pool for the value nodes.
+/// Blocks are carved from big chunks and recycled with a per-thread free list,
+/// surplus blocks are handed over in batches to a global depot so that memory
+/// freed by one thread can be reused by another. The list of an exiting thread
+/// goes to the depot as well. Chunks are never released.
+template <size_t Size>
+class node_pool{
+public:
+    union block{
+        block* next;
+        char   data[Size];
+    };
+
+    static void* allocate(){
+        local& l=tls();
+        if(!l.head) refill(l);
+        block* b=l.head;
+        l.head=b->next;
+        --l.count;
+        if(l.retired) flush(l);
+        alloc_stats::count(alloc_stats::pool_alloc);
+        return b;
+    }
+
+    static void deallocate(void* p){
+        local& l=tls();
+        block* b=(block*)p;
+        b->next=l.head;
+        l.head=b;
+        alloc_stats::count(alloc_stats::pool_free);
+        ++l.count;
+        if(l.retired) flush(l);// freed by a thread_local destroyed after the list
+        else if(l.count>=2*batch_size) release(l);
+    }
+
+private:
+    enum{chunk_size=Size*64<65536?65536/Size:64,
+         batch_size=chunk_size/16<16?16:chunk_size/16};
+
+    struct local{
+        block* head=nullptr;
+        size_t count=0;
+        bool   retired=false;
+        ~local(){
+            retired=true;
+            flush(*this);
+        }
+    };
+
+    struct depot{
+        std::mutex                           mutex;
+        std::vector<std::pair<block*,size_t>> batches;
+    };
+
+    static local& tls(){
+        static thread_local local l;
+        return l;
+    }
+
+    static depot& global(){
+        static depot* d=new depot();// never destroyed, nodes may be freed after exit
+        return *d;
+    }
+
+    static void refill(local& l){
+        {
+            depot& d=global();
+            std::unique_lock<std::mutex> lock(d.mutex);
+            if(d.batches.size()){
+                l.head=d.batches.back().first;
+                l.count=d.batches.back().second;
+                d.batches.pop_back();
+                return;
+            }
+        }
+        block* chunk=(block*)::operator new(sizeof(block)*chunk_size);
+        alloc_stats::pool_bytes()+=sizeof(block)*chunk_size;
+        for(size_t i=0;i+1<chunk_size;i++) chunk[i].next=&chunk[i+1];
+        chunk[chunk_size-1].next=l.head;
+        l.head=chunk;
+        l.count+=chunk_size;
+    }
+
+    static void release(local& l){
+        block* first=l.head,*last=first;
+        for(size_t i=1;i<batch_size;i++) last=last->next;
+        l.head=last->next;
+        l.count-=batch_size;
+        last->next=nullptr;
+        depot& d=global();
+        std::unique_lock<std::mutex> lock(d.mutex);
+        d.batches.emplace_back(first,batch_size);
+    }
+
+    // hands the whole list to the depot, it may be shorter than a batch
+    static void flush(local& l){
+        if(!l.head) return;
+        {
+            depot& d=global();
+            std::unique_lock<std::mutex> lock(d.mutex);
+            d.batches.emplace_back(l.head,l.count);
+        }
+        l.head=nullptr;
+        l.count=0;
+    }
+};
+
+/// Memory region of a SvarArena. Nodes are bump allocated by the thread owning the arena,
+/// and nothing is freed until the arena is closed and the last node is released,
+/// then all blocks are freed at once. Nodes may be released by any thread.
+class arena_region{
+public:
+    explicit arena_region(size_t block_size)
+        : _cur(nullptr),_end(nullptr),_block_size(block_size),_refs(1){
+        alloc_stats::arena_regions()++;
+    }
+
+    void* allocate(size_t size){
+        size=(size+15)/16*16;
+        if(_cur+size>_end){
+            size_t bytes=size>_block_size?size:_block_size;
+            _cur=(char*)::operator new(bytes);
+            _end=_cur+bytes;
+            _blocks.push_back(_cur);
+            alloc_stats::arena_bytes()+=bytes;
+            _reserved+=bytes;
+        }
+        void* p=_cur;
+        _cur+=size;
+        _refs.fetch_add(1,std::memory_order_relaxed);
+        alloc_stats::count(alloc_stats::arena_alloc);
+        return p;
+    }
+
+    void release(){
+        if(_refs.fetch_sub(1,std::memory_order_acq_rel)!=1) return;
+        for(char* b:_blocks) ::operator delete(b);
+        alloc_stats::arena_bytes()-=_reserved;
+        alloc_stats::arena_regions()--;
+        delete this;
+    }
+
+    /// The arena active on this thread, nullptr when the nodes come from the pools
+    static arena_region*& current(){
+        static thread_local arena_region* r=nullptr;
+        return r;
+    }
+
+private:
+    std::vector<char*>  _blocks;
+    char               *_cur,*_end;
+    size_t              _block_size,_reserved=0;
+    std::atomic<size_t> _refs;
+};
+
+/// Size class of the node pools, nodes larger than pooled_max go to the heap
+template <size_t Size>
+struct pool_size{
+    enum{value=Size<=128?(Size+15)/16*16:(Size+63)/64*64};
+};
+enum{pooled_max=512};
+
+/// Allocator for std::allocate_shared, the shared_ptr control block and the
+/// value are placed together in one block from the node pools or the arena.
+/// The allocator is stored in the control block, so the node is freed where it came from.
+template <typename T>
+struct pool_allocator{
+    typedef T value_type;
+
+    pool_allocator(arena_region* arena=nullptr):_arena(arena){}
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& r):_arena(r._arena){}
+
+    T* allocate(size_t n){
+        if(n!=1||alignof(T)>16){
+            alloc_stats::count(alloc_stats::heap_alloc);
+            return (T*)::operator new(n*sizeof(T));
+        }
+        if(_arena) return (T*)_arena->allocate(sizeof(T));
+        if(sizeof(T)>pooled_max){
+            alloc_stats::count(alloc_stats::heap_alloc);
+            return (T*)::operator new(sizeof(T));
+        }
+        return (T*)node_pool<pool_size<sizeof(T)>::value>::allocate();
+    }
+
+    void deallocate(T* p,size_t n){
+        if(n!=1||alignof(T)>16) return ::operator delete(p);
+        if(_arena) return _arena->release();
+        if(sizeof(T)>pooled_max) return ::operator delete(p);
+        node_pool<pool_size<sizeof(T)>::value>::deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>& r)const{return _arena==r._arena;}
+    template <typename U>
+    bool operator!=(const pool_allocator<U>& r)const{return _arena!=r._arena;}
+
+    arena_region* _arena;
+};
+
+/// Create a value node from the arena active on this thread or from the node pools
+template <typename T,typename... Args>
+std::shared_ptr<T> make_node(Args&&... args){
+    return std::allocate_shared<T>(pool_allocator<T>(arena_region::current()),std::forward<Args>(args)...);
+}
+
+/// Threads shared by the batch calls and parsers, started on first use and kept until exit.
+/// The caller of parallel_for takes tasks as well, so it finishes even when all workers
+/// are busy, and a task may call parallel_for again. Tasks must not throw.
+class worker_pool{
+public:
+    static void parallel_for(size_t n,const std::function<void(size_t)>& task){
+        if(n<=1){
+            if(n) task(0);
+            return;
+        }
+        worker_pool& p=instance();
+        std::shared_ptr<job> j=std::make_shared<job>(task,n);
+        {
+            std::unique_lock<std::mutex> lock(p._mutex);
+            p._jobs.push_back(j);
+        }
+        p._cond.notify_all();
+        while(j->run()) ;
+        {
+            std::unique_lock<std::mutex> lock(p._mutex);
+            auto it=std::find(p._jobs.begin(),p._jobs.end(),j);
+            if(it!=p._jobs.end()) p._jobs.erase(it);
+        }
+        std::unique_lock<std::mutex> lock(j->mutex);
+        j->cond.wait(lock,[&](){return j->done==n;});
+    }
+
+private:
+    struct job{
+        job(const std::function<void(size_t)>& t,size_t count):task(t),n(count),next(0),done(0){}
+
+        // runs one task, false when all are taken
+        bool run(){
+            size_t i=next++;
+            if(i>=n) return false;
+            task(i);
+            std::unique_lock<std::mutex> lock(mutex);
+            if(++done==n) cond.notify_all();
+            return true;
+        }
+
+        const std::function<void(size_t)>& task;// valid until done, the caller waits for it
+        size_t                  n;
+        std::atomic<size_t>     next;
+        size_t                  done;
+        std::mutex              mutex;
+        std::condition_variable cond;
+    };
+
+    worker_pool(){
+        size_t n=std::max(2u,std::thread::hardware_concurrency())-1;
+        for(size_t i=0;i<n;i++) std::thread([this](){work();}).detach();
+    }
+
+    static worker_pool& instance(){
+        static worker_pool* p=new worker_pool();// never destroyed, the workers wait until exit
+        return *p;
+    }
+
+    void work(){
+        while(true){
+            std::shared_ptr<job> j;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cond.wait(lock,[this](){return !_jobs.empty();});
+                j=_jobs.front();
+            }
+            if(j->run()) continue;
+            std::unique_lock<std::mutex> lock(_mutex);
+            if(!_jobs.empty()&&_jobs.front()==j) _jobs.pop_front();
+        }
+    }
+
+    std::mutex                        _mutex;
+    std::condition_variable           _cond;
+    std::deque<std::shared_ptr<job> > _jobs;
+};
+
+
+/// Map for the object members. The first ChunkSize*MaxChunks entries are kept in
+/// small pooled chunks and found by a linear scan, later entries go to a hash table.
+/// Like std::unordered_map, references to values stay valid until they are erased.
+template <typename Key,typename T,typename Hash,size_t ChunkSize=4,size_t MaxChunks=3>
+class small_map{
+public:
+    typedef std::pair<const Key,T>                 value_type;
+    typedef std::unordered_map<Key,T,Hash>         overflow_type;
+
+    struct chunk{
+        typename std::aligned_storage<sizeof(value_type),alignof(value_type)>::type slots[ChunkSize];
+        chunk*   next;
+        unsigned live;// bit i is set when slots[i] holds a value
+
+        value_type& at(size_t i){return *reinterpret_cast<value_type*>(&slots[i]);}
+    };
+
+    template <typename V>
+    class iterator_base{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef V                         value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef V*                        pointer;
+        typedef V&                        reference;
+
+        iterator_base():_map(nullptr),_chunk(nullptr),_idx(0){}
+        iterator_base(const small_map* m,chunk* c,size_t i)
+            :_map(m),_chunk(c),_idx(i){skip();}
+        iterator_base(const small_map* m,typename overflow_type::iterator it)
+            :_map(m),_chunk(nullptr),_idx(0),_it(it){}
+        template <typename V2>
+        iterator_base(const iterator_base<V2>& rh)
+            :_map(rh._map),_chunk(rh._chunk),_idx(rh._idx),_it(rh._it){}
+
+        V& operator*()const{return _chunk?_chunk->at(_idx):*_it;}
+        V* operator->()const{return &**this;}
+
+        iterator_base& operator++(){
+            if(_chunk) {++_idx;skip();}
+            else ++_it;
+            return *this;
+        }
+
+        iterator_base operator++(int){iterator_base r=*this;++*this;return r;}
+
+        template <typename V2>
+        bool operator==(const iterator_base<V2>& rh)const{
+            if(_chunk||rh._chunk) return _chunk==rh._chunk&&_idx==rh._idx;
+            return !_map->_overflow||_it==rh._it;
+        }
+        template <typename V2>
+        bool operator!=(const iterator_base<V2>& rh)const{return !(*this==rh);}
+
+    private:
+        friend class small_map;
+        template <typename V2> friend class iterator_base;
+
+        // move to the next live slot, continue with the hash table after the last chunk
+        void skip(){
+            while(_chunk){
+                for(;_idx<ChunkSize;++_idx)
+                    if(_chunk->live&(1u<<_idx)) return;
+                _chunk=_chunk->next;
+                _idx=0;
+            }
+            if(_map->_overflow) _it=_map->_overflow->begin();
+        }
+
+        const small_map*                  _map;
+        chunk*                            _chunk;
+        size_t                            _idx;
+        typename overflow_type::iterator  _it;
+    };
+
+    typedef iterator_base<value_type>       iterator;
+    typedef iterator_base<const value_type> const_iterator;
+
+    small_map():_head(nullptr),_size(0){}
+    small_map(const small_map& rh):_head(nullptr),_size(0){
+        for(const value_type& v:rh) insert(v);
+    }
+    small_map(small_map&& rh):_head(rh._head),_size(rh._size),_overflow(std::move(rh._overflow)){
+        rh._head=nullptr;
+        rh._size=0;
+    }
+    ~small_map(){clear();}
+
+    small_map& operator=(const small_map& rh){
+        if(this==&rh) return *this;
+        clear();
+        for(const value_type& v:rh) insert(v);
+        return *this;
+    }
+
+    small_map& operator=(small_map&& rh){
+        if(this==&rh) return *this;
+        clear();
+        std::swap(_head,rh._head);
+        std::swap(_size,rh._size);
+        _overflow=std::move(rh._overflow);
+        return *this;
+    }
+
+    size_t size()const{return _size;}
+    bool   empty()const{return _size==0;}
+
+    iterator       begin(){return iterator(this,_head,0);}
+    const_iterator begin()const{return const_iterator(this,_head,0);}
+    iterator       end(){return end_impl();}
+    const_iterator end()const{return end_impl();}
+
+    iterator find(const Key& key){
+        for(chunk* c=_head;c;c=c->next)
+            for(size_t i=0;i<ChunkSize;i++)
+                if((c->live&(1u<<i))&&c->at(i).first==key) return iterator(this,c,i);
+        if(_overflow){
+            auto it=_overflow->find(key);
+            if(it!=_overflow->end()) return iterator(this,it);
+        }
+        return end();
+    }
+
+    const_iterator find(const Key& key)const{return const_cast<small_map*>(this)->find(key);}
+
+    size_t count(const Key& key)const{return find(key)!=end();}
+
+    std::pair<iterator,bool> insert(const value_type& v){
+        iterator it=find(v.first);
+        if(it!=end()) return std::make_pair(it,false);
+        return std::make_pair(emplace_new(v.first,v.second),true);
+    }
+
+    template <typename K,typename V>
+    std::pair<iterator,bool> insert(std::pair<K,V>&& v){
+        iterator it=find(v.first);
+        if(it!=end()) return std::make_pair(it,false);
+        return std::make_pair(emplace_new(std::move(v.first),std::move(v.second)),true);
+    }
+
+    T& operator[](const Key& key){
+        iterator it=find(key);
+        if(it!=end()) return it->second;
+        return emplace_new(key,T())->second;
+    }
+
+    size_t erase(const Key& key){
+        for(chunk* c=_head;c;c=c->next)
+            for(size_t i=0;i<ChunkSize;i++)
+                if((c->live&(1u<<i))&&c->at(i).first==key){
+                    c->at(i).~value_type();
+                    c->live&=~(1u<<i);
+                    --_size;
+                    return 1;
+                }
+        if(_overflow&&_overflow->erase(key)){
+            --_size;
+            return 1;
+        }
+        return 0;
+    }
+
+    void clear(){
+        while(_head){
+            chunk* c=_head;
+            _head=c->next;
+            for(size_t i=0;i<ChunkSize;i++)
+                if(c->live&(1u<<i)) c->at(i).~value_type();
+            pool_allocator<chunk>().deallocate(c,1);
+        }
+        _overflow.reset();
+        _size=0;
+    }
+
+private:
+    iterator end_impl()const{
+        if(_overflow) return iterator(this,_overflow->end());
+        return iterator(this,typename overflow_type::iterator());
+    }
+
+    // the key is known to be absent, reuse a free slot before adding chunks
+    template <typename K,typename V>
+    iterator emplace_new(K&& key,V&& value){
+        chunk** tail=&_head;
+        size_t n=0;
+        for(chunk* c=_head;c;c=c->next,++n){
+            tail=&c->next;
+            if(c->live==(1u<<ChunkSize)-1) continue;
+            for(size_t i=0;i<ChunkSize;i++)
+                if(!(c->live&(1u<<i)))
+                    return construct(c,i,std::forward<K>(key),std::forward<V>(value));
+        }
+        if(n<MaxChunks){
+            chunk* c=pool_allocator<chunk>().allocate(1);
+            c->next=nullptr;
+            c->live=0;
+            *tail=c;
+            return construct(c,0,std::forward<K>(key),std::forward<V>(value));
+        }
+        if(!_overflow) _overflow.reset(new overflow_type());
+        ++_size;
+        return iterator(this,_overflow->emplace(std::forward<K>(key),std::forward<V>(value)).first);
+    }
+
+    template <typename K,typename V>
+    iterator construct(chunk* c,size_t i,K&& key,V&& value){
+        new (&c->slots[i]) value_type(std::forward<K>(key),std::forward<V>(value));
+        c->live|=1u<<i;
+        ++_size;
+        return iterator(this,c,i);
+    }
+
+    chunk*                          _head;
+    size_t                          _size;
+    std::unique_ptr<overflow_type>  _overflow;
+};
+
+/// Vector keeping the first N elements in place, used for function arguments so that
+/// calls with up to N arguments do not touch the heap.
+template <typename T,size_t N>
+class small_vector{
+public:
+    typedef T        value_type;
+    typedef T*       iterator;
+    typedef const T* const_iterator;
+
+    small_vector():_data(inline_data()),_size(0),_capacity(N){}
+    small_vector(std::initializer_list<T> init):small_vector(){
+        reserve(init.size());
+        for(const T& v:init) push_back(v);
+    }
+    template <typename It,typename=decltype(*std::declval<It&>())>
+    small_vector(It first,It last):small_vector(){
+        for(;first!=last;++first) push_back(*first);
+    }
+    small_vector(const small_vector& rh):small_vector(rh.begin(),rh.end()){}
+    small_vector(small_vector&& rh):small_vector(){*this=std::move(rh);}
+    ~small_vector(){
+        clear();
+        if(_data!=inline_data()) ::operator delete(_data);
+    }
+
+    small_vector& operator=(const small_vector& rh){
+        if(this==&rh) return *this;
+        clear();
+        reserve(rh.size());
+        for(const T& v:rh) push_back(v);
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& rh){
+        if(this==&rh) return *this;
+        clear();
+        if(rh._data!=rh.inline_data()){// steal the heap buffer
+            if(_data!=inline_data()) ::operator delete(_data);
+            _data=rh._data;
+            _size=rh._size;
+            _capacity=rh._capacity;
+            rh._data=rh.inline_data();
+            rh._size=0;
+            rh._capacity=N;
+            return *this;
+        }
+        for(T& v:rh) emplace_back(std::move(v));
+        rh.clear();
+        return *this;
+    }
+
+    size_t size()const{return _size;}
+    bool   empty()const{return _size==0;}
+
+    T&       operator[](size_t i){return _data[i];}
+    const T& operator[](size_t i)const{return _data[i];}
+    T&       back(){return _data[_size-1];}
+
+    iterator       begin(){return _data;}
+    const_iterator begin()const{return _data;}
+    iterator       end(){return _data+_size;}
+    const_iterator end()const{return _data+_size;}
+
+    void reserve(size_t n){
+        if(n<=_capacity) return;
+        T* data=static_cast<T*>(::operator new(n*sizeof(T)));
+        for(size_t i=0;i<_size;i++){
+            new (data+i) T(std::move(_data[i]));
+            _data[i].~T();
+        }
+        if(_data!=inline_data()) ::operator delete(_data);
+        _data=data;
+        _capacity=n;
+    }
+
+    void push_back(const T& v){emplace_back(v);}
+    void push_back(T&& v){emplace_back(std::move(v));}
+
+    template <typename... Args>
+    void emplace_back(Args&&... args){
+        if(_size==_capacity) reserve(2*_capacity);
+        new (_data+_size) T(std::forward<Args>(args)...);
+        ++_size;
+    }
+
+    iterator insert(const_iterator pos,const T& v){
+        size_t i=pos-_data;
+        T copy(v);// v may live in this vector
+        emplace_back(std::move(copy));
+        std::rotate(_data+i,_data+_size-1,_data+_size);
+        return _data+i;
+    }
+
+    void pop_back(){_data[--_size].~T();}
+
+    void clear(){
+        while(_size) pop_back();
+    }
+
+private:
+    T* inline_data(){return reinterpret_cast<T*>(&_inline);}
+    const T* inline_data()const{return reinterpret_cast<const T*>(&_inline);}
+
+    T*      _data;
+    size_t  _size,_capacity;
+    typename std::aligned_storage<N*sizeof(T),alignof(T)>::type _inline;
+};
+
 }
 namespace fast_double_parser {
 
@@ -1401,6 +2111,43 @@ class SvarExeption;
 template <typename T>
 class SvarValue_;
 
+/// Arguments of a function call, six arguments plus the bound self are stored in place
+typedef detail::small_vector<Svar,8> SvarArgs;
+
+/// Scoped arena for the value nodes. While an arena is alive, the nodes created by this
+/// thread (numbers, strings, objects, arrays...) are bump allocated from one region,
+/// which is freed at once after the arena is closed and all its nodes are released.
+/// Nodes can outlive the arena, the region is kept until the last of them is released.
+/// @code
+/// Svar tree;
+/// {
+///     SvarArena arena;
+///     tree=Svar::parse_json(text);
+/// }
+/// @endcode
+class SvarArena{
+public:
+    explicit SvarArena(size_t block_size=64*1024)
+        : _region(new detail::arena_region(block_size)),
+          _previous(detail::arena_region::current()){
+        detail::arena_region::current()=_region;
+    }
+
+    ~SvarArena(){
+        detail::arena_region::current()=_previous;
+        _region->release();
+    }
+
+    SvarArena(const SvarArena&)=delete;
+    SvarArena& operator=(const SvarArena&)=delete;
+
+    /// Allocation statistics of the value nodes, also available as __builtin__.memory()
+    static Svar stats();
+
+private:
+    detail::arena_region *_region,*_previous;
+};
+
 enum value_t : std::uint8_t
 {
     undefined_t,        ///< undefined value
@@ -1418,64 +2165,268 @@ enum value_t : std::uint8_t
     property_t,         ///< class property
     exception_t,        ///< svar exception
     argument_t,         ///< svar argument
-    others_t            ///< user defined types
+    others_t,           ///< user defined types
+    integer64_t         ///< number value (64-bit signed integer), appended to keep the older tags
 };
 
-class Svar{
+namespace detail {
+
+/// The type tag stored in SvarValue_<T>, user defined types and wrapped pointers are others_t
+template <typename T> struct json_type{static constexpr value_t value=others_t;};
+template <> struct json_type<std::nullptr_t>{static constexpr value_t value=null_t;};
+template <> struct json_type<bool>{static constexpr value_t value=boolean_t;};
+template <> struct json_type<int>{static constexpr value_t value=integer_t;};
+template <> struct json_type<int64_t>{static constexpr value_t value=integer64_t;};
+template <> struct json_type<double>{static constexpr value_t value=float_t;};
+template <> struct json_type<std::string>{static constexpr value_t value=string_t;};
+template <> struct json_type<SvarArray>{static constexpr value_t value=array_t;};
+template <> struct json_type<SvarObject>{static constexpr value_t value=object_t;};
+template <> struct json_type<SvarDict>{static constexpr value_t value=dict_t;};
+template <> struct json_type<SvarBuffer>{static constexpr value_t value=buffer_t;};
+template <> struct json_type<SvarFunction>{static constexpr value_t value=function_t;};
+template <> struct json_type<SvarClass>{static constexpr value_t value=svarclass_t;};
+template <> struct json_type<SvarExeption>{static constexpr value_t value=exception_t;};
+template <> struct json_type<void>{static constexpr value_t value=undefined_t;};
+
+/// Lock free table of class objects indexed by their dense ids.
+/// Slots live in chunks which are never released, so lookups only need atomic loads.
+class class_table{
 public:
-    /// The bare value
-    Svar(const std::shared_ptr<SvarValue>& v)
-        : _obj(v){}
+    static class_table& global(){
+        static class_table* table=new class_table();// never destroyed, classes may outlive statics
+        return *table;
+    }
 
-    /// Undefined singleton
-    Svar():Svar(Undefined()){}
+    /// Ids of destroyed classes are given to new ones, the lookups stay lock free
+    uint32_t insert(SvarClass* cls){
+        uint32_t id;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if(_free.size()){
+                id=_free.back();
+                _free.pop_back();
+            }
+            else if(_next.load(std::memory_order_relaxed)<chunk_size*max_chunks)
+                id=_next.load(std::memory_order_relaxed);
+            else
+                throw std::length_error("Too many SvarClass alive.");
+            // the slot is filled before at() accepts the id
+            slot(id).store(cls,std::memory_order_release);
+            if(id==_next.load(std::memory_order_relaxed))
+                _next.store(id+1,std::memory_order_release);
+        }
+        return id;
+    }
 
-    /// Wrap boolean, not singleton
-    Svar(bool b);
+    void erase(uint32_t id){
+        slot(id).store(nullptr,std::memory_order_release);
+        std::unique_lock<std::mutex> lock(_mutex);
+        _free.push_back(id);
+    }
 
-    /// Wrap a int, uint_8, int_8, short .ext
-    Svar(int i);
+    SvarClass* at(uint32_t id)const{
+        if(id>=_next.load(std::memory_order_acquire)) return nullptr;
+        std::atomic<SvarClass*>* chunk=_chunks[id/chunk_size].load(std::memory_order_acquire);
+        if(!chunk) return nullptr;
+        return chunk[id%chunk_size].load(std::memory_order_acquire);
+    }
 
-    /// Wrap a double or float
-    Svar(double  d);
+    uint32_t size()const{return _next.load(std::memory_order_acquire);}
 
-    /// Wrap a string or const char*
-    Svar(const std::string& str);
-    Svar(std::string&& str); // Fast construct with rvalue
+private:
+    static constexpr uint32_t chunk_size=256,max_chunks=4096;
 
-    /// Accelerate array with std::move
-    Svar(std::vector<Svar>&& rvec);
+    class_table():_next(0){
+        for(auto& c:_chunks) c.store(nullptr,std::memory_order_relaxed);
+    }
 
-    /// Wrap anything with template caster for user customize, including STLs
-    template <typename T>
-    Svar(const T& var);
-    template <typename T>
-    Svar(detail::enable_if_t<!std::is_same<T,Svar>::value,T>&& var);
+    std::atomic<SvarClass*>& slot(uint32_t id){
+        std::atomic<std::atomic<SvarClass*>*>& entry=_chunks[id/chunk_size];
+        std::atomic<SvarClass*>* chunk=entry.load(std::memory_order_acquire);
+        if(!chunk){
+            std::atomic<SvarClass*>* fresh=new std::atomic<SvarClass*>[chunk_size];
+            for(uint32_t i=0;i<chunk_size;i++) fresh[i].store(nullptr,std::memory_order_relaxed);
+            if(entry.compare_exchange_strong(chunk,fresh,std::memory_order_acq_rel))
+                chunk=fresh;
+            else delete[] fresh;// another thread installed the chunk first
+        }
+        return chunk[id%chunk_size];
+    }
 
-    /// Wrap an pointer use unique_ptr, should std::move since uncopyable
-    template <typename T>
-    Svar(std::unique_ptr<T>&& v);
+    std::atomic<std::atomic<SvarClass*>*> _chunks[max_chunks];
+    std::atomic<uint32_t>                 _next;
+    std::mutex                            _mutex;// of insert and erase
+    std::vector<uint32_t>                 _free;
+};
 
-    /// Construct from initializer to construct array or objects
-    Svar(const std::initializer_list<Svar>& init);
+/// Interned key string, its hash and the reference count of keys owning an atom that is not interned
+struct key_info{
+    key_info(size_t h,bool in):hash(h),interned(in),refs(1){}
 
-    /// Construct a cpp_function from a vanilla function pointer
-    template <typename Return, typename... Args, typename... Extra>
-    Svar(Return (*f)(Args...), const Extra&... extra);
+    const size_t                hash;
+    const bool                  interned;
+    mutable std::atomic<size_t> refs;
+};
 
-    /// Construct a cpp_function from a lambda function (possibly with internal state)
-    template <typename Func, typename... Extra>
-    static Svar lambda(Func &&f, const Extra&... extra);
+/// Global atom table of object keys, sharded to keep interning from different threads apart.
+/// Atoms live in node based maps and are never released, so their addresses stay valid.
+/// Each shared library has its own table, atoms keep the string hash to compare across them.
+/// Once the table holds max_atoms strings, new strings are not interned. Their keys own a
+/// counted atom released with the last key, so keys of loaded data such as ids stay bounded.
+class key_table{
+public:
+    typedef std::pair<const std::string,key_info> atom;
 
-    /// Construct a cpp_function from a class method (non-const)
-    template <typename Return, typename Class, typename... arg, typename... Extra>
-    Svar(Return (Class::*f)(arg...), const Extra&... extra);
+    enum{max_atoms=1<<16};
 
-    /// Construct a cpp_function from a class method (const)
-    template <typename Return, typename Class, typename... arg, typename... Extra>
-    Svar(Return (Class::*f)(arg...) const, const Extra&... extra);
+    static key_table& global(){
+        static key_table* table=new key_table();// never destroyed, keys may outlive statics
+        return *table;
+    }
 
-    /// Create any other c++ type instance, T need to be a copyable type
+    const atom* intern(const std::string& str){
+        size_t hash=std::hash<std::string>()(str);
+        shard& s=_shards[hash%shard_count];
+        {
+            std::unique_lock<std::mutex> lock(s.mutex);
+            auto it=s.atoms.find(str);
+            if(it!=s.atoms.end()) return &*it;
+            if(s.atoms.size()<max_atoms/shard_count)
+                return &*s.atoms.emplace(std::piecewise_construct,std::forward_as_tuple(str),
+                                         std::forward_as_tuple(hash,true)).first;
+        }
+        return new atom(std::piecewise_construct,std::forward_as_tuple(str),std::forward_as_tuple(hash,false));
+    }
+
+    size_t size(){
+        size_t sz=0;
+        for(shard& s:_shards){
+            std::unique_lock<std::mutex> lock(s.mutex);
+            sz+=s.atoms.size();
+        }
+        return sz;
+    }
+
+private:
+    static constexpr size_t shard_count=16;
+
+    struct shard{
+        std::mutex mutex;
+        std::unordered_map<std::string,key_info> atoms;
+    };
+
+    shard _shards[shard_count];
+};
+
+}
+
+/// Interned object key: equal strings share one atom, so keys usually compare by address.
+/// Keys interned by another shared library or made once the table is full have other atoms
+/// and are compared by hash and string. Hot keys can be interned once and reused,
+/// eg. static const SvarKey name("name");
+class SvarKey{
+public:
+    SvarKey():_str(detail::key_table::global().intern(std::string())){}
+    explicit SvarKey(const std::string& str):_str(detail::key_table::global().intern(str)){}
+    explicit SvarKey(const char* str):_str(detail::key_table::global().intern(str)){}
+    SvarKey(const SvarKey& rh):_str(rh._str){retain();}
+    ~SvarKey(){release();}
+
+    SvarKey& operator=(const SvarKey& rh){
+        rh.retain();
+        release();
+        _str=rh._str;
+        return *this;
+    }
+
+    const std::string& str()const{return _str->first;}
+    operator const std::string&()const{return _str->first;}
+
+    bool operator==(const SvarKey& rh)const{
+        return _str==rh._str||(_str->second.hash==rh._str->second.hash&&_str->first==rh._str->first);
+    }
+    bool operator!=(const SvarKey& rh)const{return !(*this==rh);}
+    bool operator<(const SvarKey& rh)const{return _str->first<rh._str->first;}
+
+    struct Hash{
+        size_t operator()(const SvarKey& key)const{return key._str->second.hash;}
+    };
+
+    /// Number of interned keys
+    static size_t count(){return detail::key_table::global().size();}
+
+private:
+    void retain()const{
+        if(!_str->second.interned) _str->second.refs.fetch_add(1,std::memory_order_relaxed);
+    }
+
+    void release(){
+        if(!_str->second.interned&&_str->second.refs.fetch_sub(1,std::memory_order_acq_rel)==1)
+            delete _str;
+    }
+
+    const detail::key_table::atom* _str;
+};
+
+class Svar{
+public:
+    /// The bare value
+    Svar(const std::shared_ptr<SvarValue>& v)
+        : _obj(v){}
+
+    /// Undefined singleton
+    Svar():Svar(Undefined()){}
+
+    /// Wrap boolean, not singleton.
+    /// Scalars and strings are allocated from a pooled node allocator.
+    Svar(bool b);
+
+    /// Wrap a int, uint_8, int_8, short .ext
+    Svar(int i);
+
+    /// Wrap a 64-bit integer, kept as int64_t even when it fits in int
+    Svar(int64_t i);
+
+    /// Wrap a double or float
+    Svar(double  d);
+
+    /// Wrap a string or const char*
+    Svar(const std::string& str);
+    Svar(std::string&& str); // Fast construct with rvalue
+
+    /// Accelerate array with std::move
+    Svar(std::vector<Svar>&& rvec);
+
+    /// Wrap anything with template caster for user customize, including STLs
+    template <typename T>
+    Svar(const T& var);
+    template <typename T>
+    Svar(detail::enable_if_t<!std::is_same<T,Svar>::value,T>&& var);
+
+    /// Wrap an pointer use unique_ptr, should std::move since uncopyable
+    template <typename T>
+    Svar(std::unique_ptr<T>&& v);
+
+    /// Construct from initializer to construct array or objects
+    Svar(const std::initializer_list<Svar>& init);
+
+    /// Construct a cpp_function from a vanilla function pointer
+    template <typename Return, typename... Args, typename... Extra>
+    Svar(Return (*f)(Args...), const Extra&... extra);
+
+    /// Construct a cpp_function from a lambda function (possibly with internal state)
+    template <typename Func, typename... Extra>
+    static Svar lambda(Func &&f, const Extra&... extra);
+
+    /// Construct a cpp_function from a class method (non-const)
+    template <typename Return, typename Class, typename... arg, typename... Extra>
+    Svar(Return (Class::*f)(arg...), const Extra&... extra);
+
+    /// Construct a cpp_function from a class method (const)
+    template <typename Return, typename Class, typename... arg, typename... Extra>
+    Svar(Return (Class::*f)(arg...) const, const Extra&... extra);
+
+    /// Create any other c++ type instance, T need to be a copyable type
     template <class T>
     static Svar create(const T& t);
 
@@ -1508,6 +2459,11 @@ public:
     /// Deep copy a object, non-copyable things may become Undefined
     Svar                    clone(int depth=0)const;
 
+    /// Hash used by dict keys, numbers that compare equal hash equal,
+    /// other types call __hash__ or fall back to the value address.
+    /// Throws for a type defining __eq__ without __hash__, as Python does.
+    size_t                  hash()const;
+
     /// Return the value typename
     std::string             typeName()const;
 
@@ -1569,6 +2525,11 @@ public:
     detail::enable_if_t<!std::is_reference<T>::value&&!std::is_pointer<T>::value,T>
     castAs()const;
 
+    /// Cast to c++ type T like castAs<T>(), return false instead of throwing when no caster
+    /// gives T. Containers such as std::vector<T> still throw when an item fails to cast.
+    template <typename T>
+    bool tryCast(T& out)const;
+
     /// This is the same to castAs<T>()
     template <typename T>
     T get(){return castAs<T>();}
@@ -1578,10 +2539,17 @@ public:
     template <typename T>
     T get(const std::string& name,T def,bool parse_dot=false);
 
+    /// Same to get(name,def) with an interned key, which is the fastest lookup
+    template <typename T>
+    T get(const SvarKey& name,T def);
+
     /// Set the child "name" to "create<T>(def)"
     template <typename T>
     void set(const std::string& name,const T& def,bool parse_dot=false);
 
+    template <typename T>
+    void set(const SvarKey& name,const T& def);
+
     /// Check if the item is not Undefined without dot compute
     bool exist(const Svar& id)const;
 
@@ -1591,35 +2559,31 @@ public:
     /// Append item when this is an array
     void push_back(const Svar& rh);
 
-    /// The svar iterator now just support array and object.
+    /// The svar iterator now just support array and object, other values are empty ranges.
     /// @code
     /// for(auto v:Svar({1,2,3})) std::cout<<v<<std::endl;
     /// @endcode
-    struct svar_interator{
-        enum IterType{Object,Array,Others};
-
-        svar_interator(Svar it,IterType tp);
-        ~svar_interator(){delete _it;}
-
-        Svar*  _it;
-        IterType  _type;
-
-        Svar operator *();
-
-        svar_interator& operator++();
-
-        bool operator==(const svar_interator& other) const;
-
-        bool operator!=(const svar_interator& other) const
-        {
-            return ! operator==(other);
-        }
-    };
+    struct svar_interator;
 
     svar_interator begin()const;
     svar_interator end()const;
     svar_interator find(const Svar& idx)const;
 
+    struct items_view;
+    struct values_view;
+
+    /// Visit the members of an object in place, without wrapping each one into a Svar.
+    /// With lock=true the object is locked until the view is destroyed, then the members
+    /// must not be accessed through other Svar calls inside the loop.
+    /// For a consistent copy without holding the lock, iterate obj.clone().items().
+    /// @code
+    /// for(const auto& it:obj.items()) std::cout<<it.first.str()<<":"<<it.second<<std::endl;
+    /// @endcode
+    items_view  items(bool lock=false)const;
+
+    /// Visit the items of an array or the member values of an object in place
+    values_view values(bool lock=false)const;
+
     /// Used to iter an object
     /// @code
     /// Svar obj={{"a":1,"b":false}};
@@ -1672,6 +2636,8 @@ public:
     bool operator >=(const Svar& rh)const{return !((*this)<rh);}//__ge__
     Svar operator [](const Svar& i) const;//__getitem__
     Svar& operator[](const Svar& name);// This is not thread safe!
+    Svar operator [](const SvarKey& key) const;
+    Svar& operator[](const SvarKey& key);
 
     template <typename T>
     detail::enable_if_t<std::is_copy_assignable<T>::value,Svar&> operator =(const T& v){
@@ -1773,10 +2739,280 @@ struct arg{
     sv::Svar    value;
 };
 
+namespace detail {
+template <> struct json_type<arg>{static constexpr value_t value=argument_t;};
+}
+
 inline arg operator"" _a(const char* str,size_t sz){
     return arg(std::string(str,sz));
 }
 
+namespace detail {
+
+/// Arguments replaced by their converted values during one call. The originals are put back
+/// when the call returns, so the next overload, the error report and the caller see them as passed.
+class arg_scratch{
+public:
+    explicit arg_scratch(SvarArgs& args):_args(args){}
+    ~arg_scratch(){
+        for(auto& s:_saved) std::swap(_args[s.first],s.second);
+    }
+
+    void replace(size_t i,Svar&& var){
+        _saved.emplace_back(i,std::move(var));
+        std::swap(_args[i],_saved.back().second);
+    }
+
+private:
+    SvarArgs& _args;
+    small_vector<std::pair<size_t,Svar>,4> _saved;
+};
+
+/// Prepare an argument for castAs<T>(), returns false instead of throwing when the caster
+/// gives no T, see SvarFunction::call_impl. Casters of containers such as std::vector<T>
+/// may still throw from castAs of their items.
+template <typename T,typename Enable=void>
+struct arg_caster;
+
+/// Type of SvarFunction::mismatch(), compared by type so that it works across modules
+struct arg_mismatch{};
+
+template <typename... Args>
+struct arg_converter{
+    static bool convert(SvarArgs&,size_t,arg_scratch&){return true;}
+};
+
+template <typename A,typename... Rest>
+struct arg_converter<A,Rest...>{
+    static bool convert(SvarArgs& args,size_t i,arg_scratch& scratch){
+        return arg_caster<A>::convert(args,i,scratch)&&arg_converter<Rest...>::convert(args,i+1,scratch);
+    }
+};
+
+/// True when all types are arithmetic after removing references and cv qualifiers
+template <typename... T> struct all_arithmetic : public std::true_type{};
+template <typename T,typename... Rest> struct all_arithmetic<T,Rest...>
+    : public std::integral_constant<bool,std::is_arithmetic<decay_t<T>>::value&&all_arithmetic<Rest...>::value>{};
+
+constexpr int buffer_log2(size_t n,int k=0){return (n<=1)?k:buffer_log2(n>>1,k+1);}
+
+/// The format character of an arithmetic type as in the python struct module, see SvarBuffer::format
+template <typename T>
+constexpr char buffer_format(){
+    return "?bBhHiIqQfdg"[std::is_same<T,bool>::value?0:1+(
+            std::is_integral<T>::value?buffer_log2(sizeof(T))*2+std::is_unsigned<T>::value:8+(
+            std::is_same<T,double>::value?1:std::is_same<T,long double>::value?2:0))];
+}
+
+template <typename T>
+inline bool number_cast(const SvarValue* v,T& out);
+
+/// Buffer item of an arithmetic argument or result, void results have no item.
+/// unbox converts tagged numbers as the argument casters do, box creates the Svar returned by a call.
+template <typename T>
+struct batch_type{
+    static constexpr char   format=buffer_format<decay_t<T>>();
+    static constexpr size_t size=sizeof(decay_t<T>);
+
+    static bool unbox(const Svar& v,char* out){return number_cast(v.value().get(),*(decay_t<T>*)out);}
+    static Svar box(const char* in){return Svar(*(const decay_t<T>*)in);}
+};
+
+template <>
+struct batch_type<void>{
+    static constexpr char   format=0;
+    static constexpr size_t size=0;
+    static constexpr Svar (*box)(const char*)=nullptr;
+};
+
+/// Direct mapped cache from a hash of the argument types to the index of the matched
+/// overload. Hash and index share one atomic word, so concurrent calls never read a torn entry.
+class overload_cache{
+public:
+    overload_cache(){clear();}
+    overload_cache(const overload_cache&){clear();}
+    overload_cache& operator=(const overload_cache&){clear();return *this;}
+
+    /// Return the cached overload index or -1
+    int find(uint64_t key)const{
+        uint64_t e=_slots[key%slot_count].load(std::memory_order_relaxed);
+        if((e&0xFF)&&(e>>8)==(key>>8)) return (int)(e&0xFF)-1;
+        return -1;
+    }
+
+    void insert(uint64_t key,size_t index){
+        if(index>=0xFF) return;
+        _slots[key%slot_count].store((key>>8<<8)|(index+1),std::memory_order_relaxed);
+    }
+
+    void clear(){
+        for(auto& s:_slots) s.store(0,std::memory_order_relaxed);
+    }
+
+    /// Set on this thread when the outcome of an overload depends on the argument values,
+    /// not only on their types: a caster was asked to convert an argument or the function body
+    /// was entered. Overloads matched after such a failure are not cached, since the failed one
+    /// may accept other values of the same types.
+    static bool& by_value(){
+        static thread_local bool e=false;
+        return e;
+    }
+
+private:
+    enum{slot_count=8};
+    std::atomic<uint64_t> _slots[slot_count];
+};
+
+/// Calls of one function while profiling is enabled, see SvarFunction::setProfiling.
+/// Every call is counted, the first calls and then one of sample_rate calls are timed,
+/// in ticks of the cheapest clock which are converted when reported.
+/// A function is listed for the report at its first profiled call and removed when destroyed.
+class call_stats{
+public:
+    call_stats(){}
+    call_stats(const call_stats&){}// counts belong to the function they were measured on
+    call_stats& operator=(const call_stats&){return *this;}
+    ~call_stats(){
+        if(!_owner.load(std::memory_order_acquire)) return;
+        registry& r=global();
+        std::unique_lock<std::mutex> lock(r.mutex);
+        r.list.erase(std::find(r.list.begin(),r.list.end(),this));
+    }
+
+    static std::atomic<bool>& enabled(){
+        static std::atomic<bool> e(false);
+        return e;
+    }
+
+    static uint64_t ticks(){
+#if (defined(__x86_64__)||defined(__i386__))&&(defined(__GNUC__)||defined(__clang__))
+        return __builtin_ia32_rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    /// Measure the ticks against steady_clock, the first call takes about 10ms
+    static void calibrate(){
+#if (defined(__x86_64__)||defined(__i386__))&&(defined(__GNUC__)||defined(__clang__))
+        static std::once_flag once;
+        std::call_once(once,[](){
+            int64_t  ns=steady_ns();
+            uint64_t t=ticks();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            int64_t  elapsed=steady_ns()-ns;
+            uint64_t counted=ticks()-t;
+            tick_scale().store(counted?double(elapsed)/counted:1.);
+        });
+#endif
+    }
+
+    /// Nanoseconds per tick, measured by calibrate
+    static double tick_ns(){
+#if (defined(__x86_64__)||defined(__i386__))&&(defined(__GNUC__)||defined(__clang__))
+        return tick_scale().load();
+#else
+        return 1e9*std::chrono::steady_clock::period::num/std::chrono::steady_clock::period::den;
+#endif
+    }
+
+    enum{always_timed=64,sample_rate=16};
+
+    /// Count a call, return the start ticks when it is timed or 0
+    uint64_t begin(const SvarFunction* owner){
+        if(!_owner.load(std::memory_order_acquire)) list(owner);
+        uint64_t n=calls.fetch_add(1,std::memory_order_relaxed);
+        return (n<always_timed||n%sample_rate==0)?ticks():0;
+    }
+
+    void end(uint64_t start,bool missed,bool thrown){
+        if(start){
+            uint64_t elapsed=ticks()-start;
+            timed.fetch_add(1,std::memory_order_relaxed);
+            total.fetch_add(elapsed,std::memory_order_relaxed);
+            uint64_t m=max.load(std::memory_order_relaxed);
+            while(elapsed>m&&!max.compare_exchange_weak(m,elapsed,std::memory_order_relaxed)){}
+        }
+        if(missed) misses.fetch_add(1,std::memory_order_relaxed);
+        if(thrown) exceptions.fetch_add(1,std::memory_order_relaxed);
+    }
+
+    void reset(){
+        calls=0;timed=0;total=0;max=0;misses=0;exceptions=0;
+    }
+
+    const SvarFunction* owner()const{return _owner.load(std::memory_order_acquire);}
+
+    /// Visit the functions called since profiling was enabled, the list is locked meanwhile
+    template <typename Func>
+    static void for_each(Func func){
+        registry& r=global();
+        std::unique_lock<std::mutex> lock(r.mutex);
+        for(call_stats* s:r.list) func(*s);
+    }
+
+    std::atomic<uint64_t> calls{0},timed{0},total{0},max{0},misses{0},exceptions{0};// total and max of the timed calls
+
+private:
+    struct registry{
+        std::mutex               mutex;
+        std::vector<call_stats*> list;
+    };
+
+    static registry& global(){
+        static registry* r=new registry();// never destroyed, functions may outlive statics
+        return *r;
+    }
+
+    static std::atomic<double>& tick_scale(){
+        static std::atomic<double> scale(1.);
+        return scale;
+    }
+
+    static int64_t steady_ns(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void list(const SvarFunction* owner){
+        registry& r=global();
+        std::unique_lock<std::mutex> lock(r.mutex);
+        if(_owner.load(std::memory_order_relaxed)) return;
+        r.list.push_back(this);
+        _owner.store(owner,std::memory_order_release);
+    }
+
+    std::atomic<const SvarFunction*> _owner{nullptr};
+};
+
+/// Functions being called on this thread, only read for error messages.
+/// Frames deeper than max_depth are counted but not recorded.
+class call_stack{
+public:
+    enum{max_depth=64};
+
+    static call_stack& current(){
+        static thread_local call_stack stack;// zero initialized, no guard needed
+        return stack;
+    }
+
+    void push(const SvarFunction* f){
+        if(_depth<max_depth) _frames[_depth]=f;
+        ++_depth;
+    }
+    void pop(){--_depth;}
+
+    size_t depth()const{return _depth;}
+    const SvarFunction* const* begin()const{return _frames;}
+    const SvarFunction* const* end()const{return _frames+(_depth<max_depth?_depth:max_depth);}
+
+private:
+    const SvarFunction* _frames[max_depth];
+    size_t              _depth;
+};
+
+}
+
 class SvarFunction{
 public:
     SvarFunction(){}
@@ -1810,111 +3046,174 @@ public:
 
     class ScopedStack{
     public:
-        ScopedStack(std::list<const SvarFunction*>& stack,const SvarFunction* var)
-            :_stack(stack){
-            _stack.push_back(var);
+        ScopedStack(const SvarFunction* var)
+            :_stack(detail::call_stack::current()){
+            _stack.push(var);
         }
-        ~ScopedStack(){_stack.pop_back();}
-        std::list<const SvarFunction*>& _stack;
+        ~ScopedStack(){_stack.pop();}
+        detail::call_stack& _stack;
     };
 
-    Svar Call(std::vector<Svar>& argv)const{
-        thread_local static std::list<const SvarFunction*> stack;
-        ScopedStack scoped_stack(stack,this);
-
-        const SvarFunction* overload=this;
-        std::vector<SvarExeption> catches;
-        for(;true;overload=&overload->next.as<SvarFunction>()){
-            if(overload->kwargs.size()){// resort args here
-                std::vector<Svar> args;
-                Svar kwargs;
-                for(auto& a:argv){
-                    if(!a.is<arg>()){
-                        args.push_back(a);
-                        continue;
-                    }
-
-                    const arg& a_ = a.as<arg>();
-                    kwargs[a_.name] = a_.value;
-                }
-                unsigned int fixarg_n = overload->arg_types.size()-overload->kwargs.size()-1;
-                if(args.size() < fixarg_n) continue;// not enough
-
-                for(unsigned int i=args.size()-fixarg_n;i<overload->kwargs.size();i++)
-                {
-                    arg  def_a = overload->kwargs[i].as<arg>();
-                    Svar val   = kwargs[def_a.name];
-                    if( val.isUndefined() )
-                        val = def_a.value;
-                    if( val.isUndefined())
-                        break;// no valid input
-                    args.push_back(val);
-                }
-                argv = args;
-            }
-            if(do_argcheck&&overload->arg_types.size()!=argv.size()+1)
-            {
-                if(!overload->next.isFunction()) {
-                    overload=nullptr;break;
-                }
-                continue;
-            }
-            try{
-                return overload->_func(argv);
-            }
-            catch(SvarExeption &e){
-                catches.push_back(e);
-            }
-            if(!overload->next.isFunction()) {
-                overload=nullptr;break;
-            }
+    /// Call the first overload accepting argv, the overload matched by each tuple of
+    /// argument types is cached so that later calls dispatch to it directly
+    Svar Call(SvarArgs& argv)const{
+        bool missed=false;
+        if(!detail::call_stats::enabled().load(std::memory_order_relaxed)) return dispatch(argv,missed);
+        uint64_t start=_stats.begin(this);
+        try{
+            Svar ret=dispatch(argv,missed);
+            _stats.end(start,missed,false);
+            return ret;
         }
-
-        if(!overload){
-            std::stringstream stream;
-            stream<<(*this)<<"Failed to call method with input arguments: [";
-            for(auto it=argv.begin();it!=argv.end();it++)
-            {
-                stream<<(it==argv.begin()?"":",")<<it->typeName();
-            }
-            stream<<"]\n"<<"Overload candidates:\n"<<(*this)<<std::endl;
-            for(auto it:catches) stream<<it.what()<<std::endl;
-            stream<<"Stack:\n";
-            for(auto& l:stack) stream<<*l;
-            throw SvarExeption(stream.str());
+        catch(...){
+            _stats.end(start,missed,true);
+            throw;
         }
+    }
 
-        return Svar::Undefined();
+    Svar Call(std::vector<Svar>& argv)const{
+        SvarArgs args(argv.begin(),argv.end());
+        return Call(args);
     }
 
     template <typename... Args>
     Svar call(Args... args)const{
-        std::vector<Svar> argv = {
-                (Svar(std::move(args)))...
-        };
+        SvarArgs argv;
+        int expand[]={0,(argv.emplace_back(std::move(args)),0)...};
+        (void)expand;
         return Call(argv);
     }
 
+    /// Call the function once per row of the columns. Arrays and buffers are iterated and must
+    /// have the same length, other values are passed to every call. Each row is dispatched as
+    /// by Call, results are returned as an array. When the first overload taking this many
+    /// arguments is declared with arithmetic types and all items are numbers, its callable runs
+    /// in a tight loop split over threads, and the results are a buffer when all columns are.
+    Svar callBatch(const std::vector<Svar>& columns,int threads=1)const;
+
+    /// callBatch with a single column
+    Svar map(const Svar& items,int threads=1)const{return callBatch({items},threads);}
+
+    /// Count the calls, their latency, overload misses and exceptions of every function.
+    /// Costs a load of the flag when disabled, also available as __builtin__.profiling(enable).
+    /// Latency is measured on a sample of the calls, total_ns is estimated from the mean.
+    /// Calls through TypedFunction handles that skip Call are not counted.
+    static void setProfiling(bool enable){
+        if(enable) detail::call_stats::calibrate();
+        detail::call_stats::enabled()=enable;
+    }
+
+    static bool profiling(){return detail::call_stats::enabled();}
+
+    /// The functions called while profiling, slowest total first, also available as __builtin__.profile()
+    static Svar profile();
+
+    /// Clear the counts of all functions
+    static void resetProfile(){
+        detail::call_stats::for_each([](detail::call_stats& s){s.reset();});
+    }
+
     /// Special internal constructor for functors, lambda functions, methods etc.
     template <typename Func, typename Return, typename... Args, typename... Extra>
     void initialize(Func &&f, Return (*)(Args...), const Extra&... extra);
 
+    typedef SvarClass* (*class_getter)();
+    void set_arg_types(const class_getter* types,size_t n);
+
+    /// The _func of all functions declared as Return(Args...), calls the std::function in _raw.
+    /// Copies of the SvarFunction share _raw, so the pointer stays valid as long as _func.
+    template <typename Return, typename... Args>
+    struct invoker{
+        const std::function<Return(Args...)>* f;
+
+        Svar operator()(SvarArgs& args)const{
+            using indices = detail::make_index_sequence<sizeof...(Args)>;
+            return call_impl(*f,(Return (*) (Args...)) nullptr,args,indices{});
+        }
+    };
+
+    /// Runs a callable declared with arithmetic result and arguments over typed buffers,
+    /// shared by all functions with the signature, see callBatch
+    struct batch_kernel{
+        typedef bool (*unboxer)(const Svar& value,char* out);
+
+        void (*loop)(const void* raw,char* const* in,const ssize_t* steps,char* out,size_t begin,size_t end);
+        Svar (*box)(const char* result);// nullptr for void
+        char                 result;     // SvarBuffer::format of the result, 0 for void
+        size_t               result_size;
+        std::string          args;       // SvarBuffer::format of each argument
+        std::vector<size_t>  arg_sizes;
+        std::vector<unboxer> unbox;
+    };
+
+    template <typename Return, typename... Args>
+    static const batch_kernel* make_batch_kernel(std::false_type){return nullptr;}
+
+    template <typename Return, typename... Args>
+    static const batch_kernel* make_batch_kernel(std::true_type){
+        static const batch_kernel kernel={&batch_loop<Return,Args...>,detail::batch_type<Return>::box,
+                                          detail::batch_type<Return>::format,detail::batch_type<Return>::size,
+                                          std::string({detail::batch_type<Args>::format...}),
+                                          {detail::batch_type<Args>::size...},
+                                          {&detail::batch_type<Args>::unbox...}};
+        return &kernel;
+    }
+
+    template <typename Return, typename... Args>
+    static void batch_loop(const void* raw,char* const* in,const ssize_t* steps,char* out,size_t begin,size_t end){
+        using indices = detail::make_index_sequence<sizeof...(Args)>;
+        batch_loop_impl(*static_cast<const std::function<Return(Args...)>*>(raw),
+                        (Return (*) (Args...)) nullptr,in,steps,out,begin,end,indices{});
+    }
+
+    template <typename Return, typename... Args,size_t... Is>
+    static detail::enable_if_t<std::is_void<Return>::value>
+    batch_loop_impl(const std::function<Return(Args...)>& f,Return (*)(Args...),char* const* in,const ssize_t* steps,
+                    char*,size_t begin,size_t end,detail::index_sequence<Is...>){
+        for(size_t i=begin;i<end;i++)
+            f(*(detail::decay_t<Args>*)(in[Is]+i*steps[Is])...);
+    }
+
+    template <typename Return, typename... Args,size_t... Is>
+    static detail::enable_if_t<!std::is_void<Return>::value>
+    batch_loop_impl(const std::function<Return(Args...)>& f,Return (*)(Args...),char* const* in,const ssize_t* steps,
+                    char* out,size_t begin,size_t end,detail::index_sequence<Is...>){
+        for(size_t i=begin;i<end;i++)
+            ((detail::decay_t<Return>*)out)[i]=f(*(detail::decay_t<Args>*)(in[Is]+i*steps[Is])...);
+    }
+
+    /// Returned by _func instead of throwing when the arguments can not be converted
+    static const Svar& mismatch();
+    static bool is_mismatch(const Svar& ret);
+
     template <typename Func, typename Return, typename... Args,size_t... Is>
-    detail::enable_if_t<std::is_void<Return>::value, Svar>
-    call_impl(Func&& f,Return (*)(Args...),std::vector<Svar>& args,detail::index_sequence<Is...>){
-        f(args[Is].castAs<Args>()...);
+    static detail::enable_if_t<std::is_void<Return>::value, Svar>
+    call_impl(Func&& f,Return (*)(Args...),SvarArgs& args,detail::index_sequence<Is...>){
+        detail::arg_scratch scratch(args);
+        if(!detail::arg_converter<Args...>::convert(args,0,scratch)) return mismatch();
+        enter(f,args[Is].castAs<Args>()...);
         return Svar::Undefined();
     }
 
     template <typename Func, typename Return, typename... Args,size_t... Is>
-    detail::enable_if_t<!std::is_void<Return>::value, Svar>
-    call_impl(Func&& f,Return (*)(Args...),std::vector<Svar>& args,detail::index_sequence<Is...>){
-        return Svar(f(args[Is].castAs<Args>()...));
+    static detail::enable_if_t<!std::is_void<Return>::value, Svar>
+    call_impl(Func&& f,Return (*)(Args...),SvarArgs& args,detail::index_sequence<Is...>){
+        detail::arg_scratch scratch(args);
+        if(!detail::arg_converter<Args...>::convert(args,0,scratch)) return mismatch();
+        return Svar(enter(f,args[Is].castAs<Args>()...));
+    }
+
+    // called with the converted arguments, marks the body as entered for the overload cache
+    template <typename Func, typename... Args>
+    static auto enter(Func& f,Args&&... args)->decltype(f(std::forward<Args>(args)...)){
+        detail::overload_cache::by_value()=true;
+        return f(std::forward<Args>(args)...);
     }
 
     void process_extra(Svar extra);
 
     Svar& overload(Svar func){
+        _cache.clear();
         Svar* dest=&next;
         while(dest->isFunction())
         {
@@ -1948,8 +3247,71 @@ public:
     Svar          meta,next;
     std::vector<Svar> arg_types,kwargs;
 
-    std::function<Svar(std::vector<Svar>&)> _func;
+    std::function<Svar(SvarArgs&)> _func;
     bool          is_method=false,is_constructor=false,do_argcheck=true;
+
+    /// Return the callable of the first overload declared exactly as R(Args...), or nullptr
+    template <typename R,typename... Args>
+    const std::function<R(Args...)>* raw()const{
+        for(const SvarFunction* overload=this;overload;){
+            if(overload->_raw_type&&*overload->_raw_type==typeid(std::function<R(Args...)>))
+                return static_cast<const std::function<R(Args...)>*>(overload->_raw.get());
+            overload=overload->next.isFunction()?&overload->next.as<SvarFunction>():nullptr;
+        }
+        return nullptr;
+    }
+
+private:
+    friend class SvarClass;
+
+    std::shared_ptr<void> _raw;// std::function with the declared signature, see raw()
+    const std::type_info* _raw_type=nullptr;
+    const batch_kernel*   _batch=nullptr;// loops _raw over buffers, see callBatch
+
+    /// Match the keyword arguments in argv to kwargs by name and fill in the defaults.
+    /// Return argv when it is complete, bound when arguments were bound, nullptr on failure.
+    SvarArgs* bind_kwargs(SvarArgs& argv,SvarArgs& bound)const;
+
+    bool try_call(SvarArgs& argv,std::vector<SvarExeption>& catches,Svar& ret,bool& by_value)const;
+
+    /// Resolve the overload and call it, missed is set when an overload tried did not match
+    Svar dispatch(SvarArgs& argv,bool& missed)const;
+
+    mutable detail::overload_cache _cache;
+    mutable detail::call_stats     _stats;
+};
+
+/// Handle calling a function with a known C++ signature. When the function has an overload
+/// declared exactly as R(Args...), it is called directly without boxing the arguments and
+/// the result, otherwise the call goes through Svar::operator() and the result is cast to R.
+/// Obtain it once and keep it: TypedFunction<int(int,int)> add=module["add"];
+template <typename Signature>
+class TypedFunction;
+
+template <typename R,typename... Args>
+class TypedFunction<R(Args...)>{
+public:
+    TypedFunction():_raw(nullptr){}
+    TypedFunction(const Svar& func);
+
+    /// True when calls skip the generic path
+    bool isDirect()const{return _raw!=nullptr;}
+
+    const Svar& function()const{return _func;}
+
+    R operator()(Args... args)const{
+        if(_raw) return (*_raw)(std::forward<Args>(args)...);
+        return result(std::is_void<R>(),std::forward<Args>(args)...);
+    }
+
+private:
+    R result(std::true_type,Args... args)const{_func(std::forward<Args>(args)...);}
+    R result(std::false_type,Args... args)const{
+        return _func(std::forward<Args>(args)...).template castAs<R>();
+    }
+
+    Svar                             _func;// keeps the function alive
+    const std::function<R(Args...)>* _raw;
 };
 
 class SvarClass{
@@ -1974,12 +3336,88 @@ public:
         sv::Svar meta;
     };
 
+    /// An attribute of the class or of a parent, the casters convert self to that parent
+    struct method{
+        std::string       name;
+        Svar              attr;
+        std::vector<Svar> casters;
+        bool              inherited;
+        size_t            next;// entry with the same name in a later parent, npos for none
+    };
+
+    /// Attributes of a class and all its parents in lookup order, the first one found wins
+    struct method_table{
+        static const size_t npos=size_t(-1);
+
+        std::vector<method>                                     entries;
+        std::unordered_map<std::string,size_t>                  index;
+        std::vector<std::pair<const SvarClass*,uint32_t> >      versions;// of the classes read
+
+        const method* find(const std::string& name)const{
+            auto it=index.find(name);
+            return it==index.end()?nullptr:&entries[it->second];
+        }
+
+        /// The same name defined by a later parent, tried when an inherited method throws
+        const method* next(const method& m)const{
+            return m.next==npos?nullptr:&entries[m.next];
+        }
+
+        /// True when m points to an entry of this table, m is not dereferenced
+        bool owns(const method* m)const{
+            uintptr_t first=(uintptr_t)entries.data(),p=(uintptr_t)m;
+            return p>=first&&p<first+entries.size()*sizeof(method)&&(p-first)%sizeof(method)==0;
+        }
+
+        bool outdated()const{
+            for(auto& v:versions)
+                if(v.first->_version.load(std::memory_order_acquire)!=v.second) return true;
+            return false;
+        }
+    };
+
     SvarClass(const std::string& name,
               std::type_index cpp_type=typeid(dynamic_class_object),
-              std::vector<Svar> parents={});
+              std::vector<Svar> parents={},
+              value_t json_type=others_t);
+
+    SvarClass(const SvarClass& rh);
+
+    ~SvarClass(){detail::class_table::global().erase(_id);}
+
+    /// The class name, c++ type names are demangled at the first request
+    const std::string& name()const{
+        if(!_named.load(std::memory_order_acquire)){
+            std::unique_lock<std::mutex> lock(name_mutex());
+            if(!_named.load(std::memory_order_relaxed)){
+                if(__name__.empty()) __name__=decodeName(_cpptype.name());
+                _cast_key=SvarKey("__"+__name__+"__");
+                _named.store(true,std::memory_order_release);
+            }
+        }
+        return __name__;
+    }
+
+    /// Rename the class, it should be named before other threads use it
+    void     setName(const std::string& nm){
+        std::unique_lock<std::mutex> lock(name_mutex());
+        __name__=nm;
+        _cast_key=SvarKey("__"+__name__+"__");
+        _named.store(true,std::memory_order_release);
+    }
+
+    /// Name of the methods converting other classes to this one, "__"+name()+"__"
+    const SvarKey& castKey()const{
+        name();
+        return _cast_key;
+    }
 
-    std::string name()const{return __name__;}
-    void     setName(const std::string& nm){__name__=nm;}
+    /// Dense id assigned at construction, unique among the live classes of this binary.
+    /// The id of a destroyed class is given to a later one.
+    uint32_t id()const{return _id;}
+
+    /// Return the class with the id, nullptr when it is not alive
+    static SvarClass* find(uint32_t id){return detail::class_table::global().at(id);}
 
     SvarClass& def(const std::string& name,const Svar& function,
                    bool isMethod=true, std::vector<Svar> extra={})
@@ -1991,7 +3429,7 @@ public:
         else
             *dest=function;
         dest->as<SvarFunction>().is_method=isMethod;
-        dest->as<SvarFunction>().name=__name__+"."+name;
+        dest->as<SvarFunction>().name=this->name()+"."+name;
         for(Svar e:extra)
             dest->as<SvarFunction>().process_extra(e);
 
@@ -2004,6 +3442,7 @@ public:
         if(__str__.is<void>()&&name=="__str__") __str__=function;
         if(__getitem__.is<void>()&&name=="__getitem__") __getitem__=function;
         if(__setitem__.is<void>()&&name=="__setitem__") __setitem__=function;
+        changed();
         return *this;
     }
 
@@ -2027,6 +3466,7 @@ public:
                             const Svar& fget,const Svar& fset=Svar(),
                             const std::string& doc=""){
         _attr[name]=SvarProperty(fget,fset,name,doc);
+        changed();
         return *this;
     }
 
@@ -2053,64 +3493,113 @@ public:
                        return dynamic_cast<Base*>(v);
                    })};
         _parents.push_back(base);
+        changed();
         return *this;
     }
 
     SvarClass& inherit(std::vector<Svar> parents={}){
         _parents=parents;
+        changed();
         return *this;
     }
 
-    Svar operator [](const std::string& name){
-        Svar& c=_attr[name];
-        if(!c.isUndefined())  return c;
-        for(Svar& p:_parents)
-        {
-            c=p.as<SvarClass>()[name];
-            if(!c.isUndefined()) return c;
+    /// The attributes of this class and its parents flattened at the first lookup.
+    /// Any change of this class or a parent makes the table outdated and it is rebuilt.
+    /// A replaced table is freed when the last reader of the class is gone.
+    class method_reader{
+    public:
+        explicit method_reader(const SvarClass& cls):_cls(cls){
+            _cls._readers.fetch_add(1);
+            _table=&_cls.methods();
         }
-        return c;
-    }
 
-    template <typename... Args>
-    Svar call(const Svar& inst,const std::string function, Args... args)const
-    {
-        std::vector<Svar> argv = {
-                (Svar(std::move(args)))...
-        };
-        return Call(inst,function,argv);
+        ~method_reader(){
+            if(_cls._readers.fetch_sub(1)==1&&_cls._retired.load()) _cls.reclaim();
+        }
+
+        const method_table& operator*()const{return *_table;}
+        const method_table* operator->()const{return _table;}
+
+    private:
+        method_reader(const method_reader&);
+        method_reader& operator=(const method_reader&);
+
+        const SvarClass&    _cls;
+        const method_table* _table;
+    };
+
+    /// Look up an attribute of the class or its parents, Undefined when not found
+    Svar operator [](const std::string& name)const{
+        method_reader table(*this);
+        const method* m=table->find(name);
+        return m?m->attr:Svar();
     }
 
-    Svar Call(const Svar& inst,const std::string function, std::vector<Svar> args)const
-    {
-        Svar f=_attr[function];
-        if(f.isFunction())
-        {
-            SvarFunction& func=f.as<SvarFunction>();
-            if(func.is_method){
-                if(inst.isUndefined())
-                    throw SvarExeption("Method should be called with self.");
-                args.insert(args.begin(),inst);
-                return func.Call(args);
-            }
-            else return func.Call(args);
-        }
+    /// The attributes defined by this class, without the parents. Change them with
+    /// def or setAttr, so that the classes looking them up see the change.
+    const Svar& attributes()const{return _attr;}
 
-        std::stringstream sst;
-        for(const Svar& p:_parents){
+    /// Set an attribute of this class, functions are usually added with def
+    SvarClass& setAttr(const std::string& name,const Svar& value){
+        _attr[name]=value;
+        changed();
+        return *this;
+    }
+
+    /// Mark the flattened attributes of this class and of the classes inheriting it outdated
+    void changed(){_version.fetch_add(1,std::memory_order_acq_rel);}
+
+    /// Call the attribute found in methods(), self is converted to the class defining it
+    static Svar invoke(const method& m,const Svar& inst,SvarArgs& args){
+        const SvarFunction& func=m.attr.as<SvarFunction>();
+        if(!func.is_method) return func.Call(args);
+        if(inst.isUndefined())
+            throw SvarExeption("Method should be called with self.");
+        Svar self=inst;
+        for(const Svar& c:m.casters) self=c(self);
+        args.insert(args.begin(),self);
+        return func.Call(args);
+    }
+
+    /// Call the first function named as m. When an inherited one throws and a later parent
+    /// defines the name too, that one is tried, the exception of the last one is passed on.
+    Svar invoke(const method_table& table,const method& m,const Svar& inst,SvarArgs& args)const{
+        std::string errors;
+        for(const method* it=&m;it;it=table.next(*it)){
+            if(!it->attr.isFunction()) continue;
+            if(!it->inherited||!table.next(*it)) return invoke(*it,inst,args);
+            SvarArgs argv=args;
             try{
-                if(p.isClass()){
-                    return p.as<SvarClass>().Call(inst,function,args);
-                }
-                return p[0].as<SvarClass>().Call(p[1](inst),function,args);
+                return invoke(*it,inst,argv);
             }
-            catch(SvarExeption &e){
-                sst<<e.what();
-                continue;
+            catch(SvarExeption& e){
+                errors+=e.what();
             }
         }
-        throw SvarExeption("Class "+__name__+" has no function "+function+sst.str());
-        return Svar::Undefined();
+        throw SvarExeption("Class "+name()+" has no function "+m.name+errors);
+    }
+
+    template <typename... Args>
+    Svar call(const Svar& inst,const std::string& function, Args... args)const
+    {
+        SvarArgs argv;
+        int expand[]={0,(argv.emplace_back(std::move(args)),0)...};
+        (void)expand;
+        return Call(inst,function,std::move(argv));
+    }
+
+    Svar Call(const Svar& inst,const std::string& function, const std::vector<Svar>& args)const
+    {
+        return Call(inst,function,SvarArgs(args.begin(),args.end()));
+    }
+
+    Svar Call(const Svar& inst,const std::string& function, SvarArgs args)const
+    {
+        method_reader table(*this);
+        const method* m=table->find(function);
+        if(!m)
+            throw SvarExeption("Class "+name()+" has no function "+function);
+        return invoke(*table,*m,inst,args);
     }
 
     static std::string decodeName(const char* __mangled_name){
@@ -2128,9 +3617,9 @@ public:
     template <typename T>
     static SvarClass* instance()
     {
-        static std::shared_ptr<SvarClass> cl;
-        if(cl) return cl.get();
-        cl=std::make_shared<SvarClass>(decodeName(typeid(T).name()),typeid(T));
+        static std::shared_ptr<SvarClass> cl=std::make_shared<SvarClass>(std::string(),typeid(T),
+                                                                          std::vector<Svar>(),
+                                                                          value_t(detail::json_type<T>::value));
         return cl.get();
     }
 
@@ -2143,13 +3632,45 @@ public:
 
     void make_constructor(sv::Svar fvar);
 
-    std::string  __name__,__doc__;
+    mutable std::string  __name__;
+    std::string  __doc__;
     std::type_index _cpptype;
-    Svar _attr,__init__,__str__,__getitem__,__setitem__;
+    Svar __init__,__str__,__getitem__,__setitem__;
     std::vector<Svar> _parents;
     value_t _json_type;
+    uint32_t _id;
+    mutable std::atomic<bool> _named;
+    mutable SvarKey _cast_key;
+
+private:
+    static std::mutex& name_mutex(){
+        static std::mutex* mutex=new std::mutex();// never destroyed, classes may outlive statics
+        return *mutex;
+    }
+
+    const method_table& methods()const{
+        const method_table* table=_methods.load();
+        if(table&&!table->outdated()) return *table;
+        return rebuild_methods();
+    }
+
+    const method_table& rebuild_methods()const;
+    void collect_methods(method_table& table,const std::vector<Svar>& casters,bool inherited)const;
+    void reclaim()const;
+
+    Svar                                         _attr;
+    std::atomic<uint32_t>                        _version{0};
+    mutable std::atomic<const method_table*>     _methods{nullptr};
+    mutable std::atomic<size_t>                  _readers{0},_retired{0};
+    // the current table is the last one, the others are freed when no reader is left
+    mutable std::vector<std::unique_ptr<method_table> > _method_tables;
+    mutable std::mutex                           _methods_mutex;
 };
 
+namespace detail {
+template <> struct json_type<SvarClass::SvarProperty>{static constexpr value_t value=property_t;};
+}
+
 template <typename C>
 class Class
 {
@@ -2523,14 +4044,11 @@ public:
         return buf;
     }
 
-    inline static constexpr int log2(size_t n, int k = 0) { return (n <= 1) ? k : log2(n >> 1, k + 1); }
+    inline static constexpr int log2(size_t n, int k = 0) { return detail::buffer_log2(n,k); }
 
     template <typename T>
     static detail::enable_if_t<std::is_arithmetic<T>::value,std::string> format(){
-      int index = std::is_same<T, bool>::value ? 0 : 1 + (
-          std::is_integral<T>::value ? log2(sizeof(T))*2 + std::is_unsigned<T>::value : 8 + (
-          std::is_same<T, double>::value ? 1 : std::is_same<T, long double>::value ? 2 : 0));
-      return std::string(1,"?bBhHiIqQfdg"[index]);
+      return std::string(1,detail::buffer_format<T>());
     }
 
     int itemsize(){
@@ -2551,20 +4069,23 @@ public:
 
 class SvarValue{
 public:
-    SvarValue(){}
+    SvarValue(value_t type=others_t):_type(type){}
     virtual ~SvarValue(){}
     typedef std::type_index TypeID;
     virtual const void*     as(const TypeID& tp)const{if(tp==typeid(void)) return this;else return nullptr;}
     virtual SvarClass*     classObject()const;
     virtual size_t          length() const {return 0;}
     virtual Svar            clone(int)const{return Svar();}
+
+    /// Set at construction for builtin types, others_t means ask classObject()
+    value_t _type;
 };
 
 template <typename T>
 class SvarValue_: public SvarValue{
 public:
-    explicit SvarValue_(const T& v):_var(v){}
-    explicit SvarValue_(T&& v):_var(std::move(v)){}
+    explicit SvarValue_(const T& v):SvarValue(detail::json_type<T>::value),_var(v){}
+    explicit SvarValue_(T&& v):SvarValue(detail::json_type<T>::value),_var(std::move(v)){}
 
     virtual const void*     as(const TypeID& tp)const{if(tp==typeid(T)) return &_var;else return nullptr;}
     virtual SvarClass*     classObject()const{return SvarClass::instance<T>();}
@@ -2627,24 +4148,35 @@ public:
     T* _var;
 };
 
-class SvarObject : public SvarValue_<std::unordered_map<std::string,Svar> >{
+class SvarObject : public SvarValue_<detail::small_map<SvarKey,Svar,SvarKey::Hash> >{
 public:
+    typedef detail::small_map<SvarKey,Svar,SvarKey::Hash> map_type;
+
     SvarObject(const std::map<std::string,Svar>& m)
-        : SvarValue_<std::unordered_map<std::string,Svar>>({}){
-        _var.insert(m.begin(),m.end());
+        : SvarValue_<map_type>(map_type()){
+        _type=object_t;
+        for(auto& it:m) _var.insert(std::make_pair(SvarKey(it.first),it.second));
     }
 
-    SvarObject(std::unordered_map<std::string,Svar>&& m)
-        : SvarValue_<std::unordered_map<std::string,Svar>>(m){
+    SvarObject(const std::unordered_map<std::string,Svar>& m)
+        : SvarValue_<map_type>(map_type()){
+        _type=object_t;
+        for(auto& it:m) _var.insert(std::make_pair(SvarKey(it.first),it.second));
     }
 
-    SvarObject(const std::unordered_map<std::string,Svar>& m)
-        : SvarValue_<std::unordered_map<std::string,Svar>>(m){
+    SvarObject(map_type&& m)
+        : SvarValue_<map_type>(std::move(m)){
+        _type=object_t;
+    }
+
+    SvarObject(const map_type& m)
+        : SvarValue_<map_type>(m){
+        _type=object_t;
     }
 
     virtual const void*     as(const TypeID& tp)const{
         if(tp==typeid(SvarObject)) return this;
-        else if(tp==typeid(std::unordered_map<std::string,Svar>)) return &_var;
+        else if(tp==typeid(map_type)) return &_var;
         else return nullptr;
     }
 
@@ -2656,16 +4188,13 @@ public:
 
     virtual Svar            clone(int depth=0)const{
         std::unique_lock<std::mutex> lock(_mutex);
-        if(depth<=0)
-            return _var;
-        auto var=_var;
-        for(auto it=var.begin();it!=var.end();it++){
-            it->second=it->second.clone(depth-1);
-        }
-        return var;
+        map_type var=_var;
+        if(depth>0)
+            for(auto& it:var) it.second=it.second.clone(depth-1);
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::move(var));
     }
 
-    Svar operator[](const std::string &key)const {//get
+    Svar operator[](const SvarKey &key)const {//get
         std::unique_lock<std::mutex> lock(_mutex);
         auto it=_var.find(key);
         if(it==_var.end()){
@@ -2674,7 +4203,9 @@ public:
         return it->second;
     }
 
-    void set(const std::string &key,const Svar& value){
+    Svar operator[](const std::string &key)const {return (*this)[SvarKey(key)];}
+
+    void set(const SvarKey &key,const Svar& value){
         std::unique_lock<std::mutex> lock(_mutex);
         auto it=_var.find(key);
         if(it==_var.end()){
@@ -2683,6 +4214,8 @@ public:
         else it->second=value;
     }
 
+    void set(const std::string &key,const Svar& value){set(SvarKey(key),value);}
+
     mutable std::mutex _mutex;
     SvarClass* _class=nullptr;
 };
@@ -2690,10 +4223,10 @@ public:
 class SvarArray : public SvarValue_<std::vector<Svar> >{
 public:
     SvarArray(const std::vector<Svar>& v)
-        :SvarValue_<std::vector<Svar>>(v){}
+        :SvarValue_<std::vector<Svar>>(v){_type=array_t;}
 
     SvarArray(std::vector<Svar>&& v)
-        :SvarValue_<std::vector<Svar>>(std::move(v)){}
+        :SvarValue_<std::vector<Svar>>(std::move(v)){_type=array_t;}
 
     virtual SvarClass*     classObject()const{return SvarClass::instance<SvarArray>();}
     virtual size_t          length() const {return _var.size();}
@@ -2712,32 +4245,188 @@ public:
 
     virtual Svar            clone(int depth=0)const{
         std::unique_lock<std::mutex> lock(_mutex);
-        if(depth<=0)
-            return _var;
         std::vector<Svar> var=_var;
-        for(auto& it:var){
-            it=it.clone(depth-1);
-        }
-        return var;
+        if(depth>0)
+            for(auto& it:var) it=it.clone(depth-1);
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarArray>(std::move(var));
     }
 
     mutable std::mutex _mutex;
 };
 
-class SvarDict : public SvarValue_<std::map<Svar,Svar> >{
+/// Iterator of Svar::begin() and Svar::end(), the container iterator is held directly.
+/// Arrays yield the items, objects yield std::pair<const std::string,Svar> of the members.
+struct Svar::svar_interator{
+    enum IterType{Object,Array,Others};
+
+    svar_interator():_type(Others){}
+    svar_interator(std::vector<Svar>::const_iterator it):_type(Array),_array(it){}
+    svar_interator(SvarObject::map_type::const_iterator it):_type(Object),_object(it){}
+
+    Svar operator *()const{
+        if(_type==Array) return *_array;
+        return std::pair<const std::string,Svar>(_object->first.str(),_object->second);
+    }
+
+    svar_interator& operator++(){
+        if(_type==Array) ++_array;
+        else if(_type==Object) ++_object;
+        return *this;
+    }
+
+    bool operator==(const svar_interator& other) const{
+        if(_type!=other._type) return false;
+        if(_type==Array) return _array==other._array;
+        if(_type==Object) return _object==other._object;
+        return true;
+    }
+
+    bool operator!=(const svar_interator& other) const
+    {
+        return ! operator==(other);
+    }
+
+    IterType                              _type;
+    std::vector<Svar>::const_iterator     _array;
+    SvarObject::map_type::const_iterator  _object;
+};
+
+/// Members of an object, see Svar::items()
+struct Svar::items_view{
+    typedef SvarObject::map_type::const_iterator iterator;
+
+    items_view(const Svar& obj,bool lock)
+        : _holder(obj),_object(obj.as<SvarObject>()),
+          _lock(_object._mutex,std::defer_lock){
+        if(lock) _lock.lock();
+    }
+
+    iterator begin()const{return _object._var.begin();}
+    iterator end()const{return _object._var.end();}
+    size_t   size()const{return _object._var.size();}
+
+private:
+    Svar                         _holder;
+    const SvarObject&            _object;
+    std::unique_lock<std::mutex> _lock;
+};
+
+/// Items of an array or member values of an object, see Svar::values()
+struct Svar::values_view{
+    class iterator{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Svar                      value_type;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const Svar*               pointer;
+        typedef const Svar&               reference;
+
+        iterator(std::vector<Svar>::const_iterator it):_is_object(false),_array(it){}
+        iterator(SvarObject::map_type::const_iterator it):_is_object(true),_object(it){}
+
+        reference operator*()const{return _is_object?_object->second:*_array;}
+        pointer   operator->()const{return &**this;}
+        iterator& operator++(){
+            if(_is_object) ++_object;
+            else ++_array;
+            return *this;
+        }
+        iterator  operator++(int){iterator r=*this;++*this;return r;}
+        bool operator==(const iterator& rh)const{
+            return _is_object?_object==rh._object:_array==rh._array;
+        }
+        bool operator!=(const iterator& rh)const{return !(*this==rh);}
+
+    private:
+        bool                                 _is_object;
+        std::vector<Svar>::const_iterator    _array;
+        SvarObject::map_type::const_iterator _object;
+    };
+
+    values_view(const Svar& var,bool lock)
+        : _holder(var),_object(var.isObject()?&var.as<SvarObject>():nullptr),
+          _array(_object?nullptr:&var.as<SvarArray>()),
+          _lock(_object?_object->_mutex:_array->_mutex,std::defer_lock){
+        if(lock) _lock.lock();
+    }
+
+    iterator begin()const{return _object?iterator(_object->_var.begin()):iterator(_array->_var.begin());}
+    iterator end()const{return _object?iterator(_object->_var.end()):iterator(_array->_var.end());}
+    size_t   size()const{return _object?_object->_var.size():_array->_var.size();}
+
+private:
+    Svar                         _holder;
+    const SvarObject*            _object;
+    const SvarArray*             _array;
+    std::unique_lock<std::mutex> _lock;
+};
+
+namespace detail {
+/// Convert between tagged numbers directly, same as __int__, __double__ and __bool__ of the builtin classes
+template <typename T>
+inline bool number_cast(const SvarValue* v,T& out){
+    switch(v->_type){
+    case integer_t: out=(T)static_cast<const SvarValue_<int>*>(v)->_var; return true;
+    case integer64_t: out=(T)static_cast<const SvarValue_<int64_t>*>(v)->_var; return true;
+    case float_t:   out=(T)static_cast<const SvarValue_<double>*>(v)->_var; return true;
+    case boolean_t: out=(T)static_cast<const SvarValue_<bool>*>(v)->_var; return true;
+    default: return false;
+    }
+}
+
+struct svar_hash{
+    size_t operator()(const Svar& key)const{return key.hash();}
+};
+
+/// Builtin values compare natively, the rest go through __eq__
+struct svar_equal{
+    bool operator()(const Svar& a,const Svar& b)const{
+        const SvarValue* l=a.value().get(),*r=b.value().get();
+        if(l==r) return true;
+        if(l->_type==string_t&&r->_type==string_t)
+            return static_cast<const SvarValue_<std::string>*>(l)->_var==
+                    static_cast<const SvarValue_<std::string>*>(r)->_var;
+        if((l->_type==integer_t||l->_type==integer64_t)&&(r->_type==integer_t||r->_type==integer64_t)){
+            int64_t il,ir;
+            number_cast(l,il);number_cast(r,ir);
+            return il==ir;
+        }
+        double dl,dr;
+        if(number_cast(l,dl)&&number_cast(r,dr)) return dl==dr;
+        if(l->_type!=others_t&&r->_type!=others_t&&l->_type!=r->_type) return false;
+        return a==b;
+    }
+};
+}
+
+class SvarDict : public SvarValue_<std::unordered_map<Svar,Svar,detail::svar_hash,detail::svar_equal> >{
 public:
+    typedef std::unordered_map<Svar,Svar,detail::svar_hash,detail::svar_equal> map_type;
+
     SvarDict(const std::map<Svar,Svar>& dict)
-        :SvarValue_<std::map<Svar,Svar> >(dict){}
+        :SvarValue_<map_type>(map_type(dict.begin(),dict.end())){_type=dict_t;}
+
+    SvarDict(map_type&& dict)
+        :SvarValue_<map_type>(std::move(dict)){_type=dict_t;}
 
     virtual const void*     as(const TypeID& tp)const{
         if(tp==typeid(SvarDict)) return this;
-        else if(tp==typeid(std::map<Svar,Svar>)) return &_var;
+        else if(tp==typeid(map_type)) return &_var;
         else return nullptr;
     }
 
     virtual SvarClass*     classObject()const{return SvarClass::instance<SvarDict>();}
 
     virtual size_t          length() const {return _var.size();}
+
+    virtual Svar            clone(int depth=0)const{
+        std::unique_lock<std::mutex> lock(_mutex);
+        map_type var=_var;
+        if(depth>0)
+            for(auto& it:var) it.second=it.second.clone(depth-1);
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarDict>(std::move(var));
+    }
+
     virtual Svar operator[](const Svar& i) {
         std::unique_lock<std::mutex> lock(_mutex);
         auto it=_var.find(i);
@@ -2757,15 +4446,25 @@ inline SvarClass*     SvarValue::classObject()const{return SvarClass::instance<v
 template <typename Func, typename Return, typename... Args, typename... Extra>
 void SvarFunction::initialize(Func &&f, Return (*)(Args...), const Extra&... extra)
 {
-    // FIXME: this template used over 50% percent of binary size and slow down compile speed
-    this->arg_types={SvarClass::instance<Return>(),SvarClass::instance<Args>()...};// about 15%
-    std::vector<Svar> extras={extra...};
-    for(Svar e:extras) process_extra(e);
+    // the type table and the invoker only depend on the signature and are shared,
+    // std::function is the only part instantiated for each Func
+    static constexpr class_getter types[]={&SvarClass::instance<Return>,&SvarClass::instance<Args>...};
+    set_arg_types(types,sizeof...(Args)+1);
+    int expand[]={0,(process_extra(extra),0)...};
+    (void)expand;
+
+    auto raw=std::make_shared<std::function<Return(Args...)>>(std::forward<Func>(f));
+    _func=invoker<Return,Args...>{raw.get()};
+    _raw=raw;
+    _raw_type=&typeid(std::function<Return(Args...)>);
+    _batch=make_batch_kernel<Return,Args...>(std::integral_constant<bool,sizeof...(Args)!=0&&
+            (std::is_void<Return>::value||detail::all_arithmetic<Return>::value)&&
+            detail::all_arithmetic<Args...>::value>());
+}
 
-    _func=[this,f](std::vector<Svar>& args)->Svar{ // about 19%
-        using indices = detail::make_index_sequence<sizeof...(Args)>;
-        return call_impl(f,(Return (*) (Args...)) nullptr,args,indices{});// about 19%
-    };
+inline void SvarFunction::set_arg_types(const class_getter* types,size_t n){
+    arg_types.resize(n);
+    for(size_t i=0;i<n;i++) arg_types[i]=types[i]();
 }
 
 inline std::string SvarFunction::signature()const{
@@ -2796,6 +4495,325 @@ inline std::string SvarFunction::signature()const{
     return sst.str();
 }
 
+inline SvarArgs* SvarFunction::bind_kwargs(SvarArgs& argv,SvarArgs& bound)const{
+    size_t positional=0,keywords=0;
+    for(const Svar& a:argv){
+        if(a.value()->_type==argument_t) keywords++;
+        else positional++;
+    }
+    size_t fixarg_n=arg_types.size()-kwargs.size()-1;
+    if(positional<fixarg_n) return nullptr;// not enough
+    if(!keywords&&positional+1>=arg_types.size()) return &argv;// nothing to bind
+
+    for(const Svar& a:argv)
+        if(a.value()->_type!=argument_t) bound.push_back(a);
+
+    // the parameter kwargs[i] takes argv[fixarg_n+i], by name or from its default
+    for(size_t i=positional-fixarg_n;i<kwargs.size();i++){
+        const arg& param=kwargs[i].as<arg>();
+        const Svar* val=&param.value;
+        for(size_t j=0;keywords&&j<argv.size();j++){
+            if(argv[j].value()->_type!=argument_t) continue;
+            const arg& a=argv[j].as<arg>();
+            if(a.name==param.name&&!a.value.isUndefined()) {val=&a.value;break;}
+        }
+        if(val->isUndefined()) break;// no valid input
+        bound.push_back(*val);
+    }
+    return &bound;
+}
+
+inline bool SvarFunction::try_call(SvarArgs& argv,std::vector<SvarExeption>& catches,Svar& ret,bool& by_value)const{
+    SvarArgs bound,*args=&argv;
+    if(kwargs.size()&&!(args=bind_kwargs(argv,bound))) return false;
+    if(do_argcheck&&arg_types.size()!=args->size()+1)
+        return false;
+
+    struct restore{
+        bool outer;
+        ~restore(){detail::overload_cache::by_value()=outer;}
+    } guard={detail::overload_cache::by_value()};
+    detail::overload_cache::by_value()=false;
+    try{
+        ret=_func(*args);
+        if(!is_mismatch(ret)) return true;
+        ret=Svar();
+        by_value|=detail::overload_cache::by_value();
+    }
+    catch(SvarExeption &e){
+        catches.push_back(e);
+        by_value=true;
+    }
+    return false;
+}
+
+inline Svar SvarFunction::dispatch(SvarArgs& argv,bool& missed)const{
+    ScopedStack scoped_stack(this);
+
+    // keyword arguments are matched by name, so only positional calls are cached.
+    // Class ids are unique in one binary only, user types are keyed by their class.
+    uint64_t key=argv.size();
+    bool cacheable=next.isFunction();
+    for(const Svar& a:argv){
+        value_t type=a.value()->_type;
+        if(type==argument_t) {cacheable=false;break;}
+        uint64_t id=(type==others_t||type==object_t)?(uint64_t)(uintptr_t)a.value()->classObject():type;
+        key=(key^id)*0x100000001b3ULL;
+    }
+
+    // an overload is cached only when all overloads before it failed because of the argument
+    // types, so that the cached one is still the first match for any values of these types
+    Svar ret;
+    std::vector<SvarExeption> catches;
+    bool by_value=false;
+    int cached=cacheable?_cache.find(key):-1;
+    const SvarFunction* overload=this;
+    if(cached>=0){
+        for(int i=0;i<cached&&overload;i++)
+            overload=overload->next.isFunction()?&overload->next.as<SvarFunction>():nullptr;
+        if(overload&&overload->try_call(argv,catches,ret,by_value)) return ret;
+        missed=true;
+    }
+
+    int index=0;
+    for(overload=this;overload;index++){
+        if(index!=cached&&overload->try_call(argv,catches,ret,by_value)){
+            if(cacheable&&!by_value) _cache.insert(key,index);
+            return ret;
+        }
+        missed=true;
+        overload=overload->next.isFunction()?&overload->next.as<SvarFunction>():nullptr;
+    }
+
+    std::stringstream stream;
+    stream<<(*this)<<"Failed to call method with input arguments: [";
+    for(auto it=argv.begin();it!=argv.end();it++)
+    {
+        stream<<(it==argv.begin()?"":",")<<it->typeName();
+    }
+    stream<<"]\n"<<"Overload candidates:\n"<<(*this)<<std::endl;
+    for(auto it:catches) stream<<it.what()<<std::endl;
+    stream<<"Stack:\n";
+    const detail::call_stack& stack=scoped_stack._stack;
+    for(const SvarFunction* l:stack) stream<<*l;
+    if(stack.depth()>detail::call_stack::max_depth)
+        stream<<"... "<<stack.depth()-detail::call_stack::max_depth<<" more frames\n";
+    throw SvarExeption(stream.str());
+    return Svar::Undefined();
+}
+
+namespace detail {
+inline size_t buffer_count(const SvarBuffer& b){
+    size_t n=1;
+    for(ssize_t s:b.shape) n*=s;
+    return n;
+}
+
+/// Offset in bytes of the i-th item in row major order
+inline ssize_t buffer_offset(const SvarBuffer& b,size_t i){
+    ssize_t offset=0;
+    for(size_t d=b.shape.size();d-->0;){
+        offset+=(i%b.shape[d])*b.strides[d];
+        i/=b.shape[d];
+    }
+    return offset;
+}
+
+/// Bytes between two items when they are evenly spaced, as in 1-D or contiguous buffers
+inline bool buffer_step(const SvarBuffer& b,ssize_t& step){
+    if(b.shape.size()==1) {step=b.strides[0];return true;}
+    size_t n=buffer_count(b);
+    ssize_t itemsize=n?b._size/n:0,expect=itemsize;
+    for(size_t d=b.shape.size();d-->0;){
+        if(b.shape[d]!=1&&b.strides[d]!=expect) return false;
+        expect*=b.shape[d];
+    }
+    step=itemsize;
+    return true;
+}
+
+/// Box the i-th item of a buffer with one of the SvarBuffer::format formats
+inline Svar buffer_item(const SvarBuffer& b,size_t i){
+    const char* p=b.ptr<char>()+buffer_offset(b,i);
+    switch(b._format.size()==1?b._format[0]:0){
+    case '?': return *(const bool*)p;
+    case 'b': return (int)*(const int8_t*)p;
+    case 'B': return (int)*(const uint8_t*)p;
+    case 'h': return (int)*(const int16_t*)p;
+    case 'H': return (int)*(const uint16_t*)p;
+    case 'i': return (int)*(const int32_t*)p;
+    case 'I': return (int64_t)*(const uint32_t*)p;
+    case 'q': return (int64_t)*(const int64_t*)p;
+    case 'Q': return (int64_t)*(const uint64_t*)p;
+    case 'f': return (double)*(const float*)p;
+    case 'd': return *(const double*)p;
+    case 'g': return (double)*(const long double*)p;
+    default:  throw SvarExeption("Unable to read items of buffer with format "+b._format+".");
+    }
+}
+}
+
+inline Svar SvarFunction::callBatch(const std::vector<Svar>& columns,int threads)const{
+    // arrays and buffers give one item per row, other columns are passed to every call
+    std::vector<const SvarArray*>  arrays(columns.size(),nullptr);
+    std::vector<const SvarBuffer*> buffers(columns.size(),nullptr);
+    size_t rows=0,iterated=0;
+    for(size_t c=0;c<columns.size();c++){
+        size_t n;
+        if(columns[c].value()->_type==array_t){
+            arrays[c]=&columns[c].as<SvarArray>();
+            n=arrays[c]->length();
+        }
+        else if(columns[c].value()->_type==buffer_t){
+            buffers[c]=&columns[c].as<SvarBuffer>();
+            n=detail::buffer_count(*buffers[c]);
+        }
+        else continue;
+        if(iterated++&&n!=rows)
+            throw SvarExeption("callBatch requires columns of the same length, got "+
+                               std::to_string(rows)+" and "+std::to_string(n)+".");
+        rows=n;
+    }
+    if(!iterated) throw SvarExeption("callBatch requires an array or buffer column.");
+
+    // the first overload taking this many arguments runs in a loop when it is declared with
+    // arithmetic types and all items are numbers, buffers with the same formats are read
+    // in place and the others are converted first
+    bool all_buffers=std::find(buffers.begin(),buffers.end(),nullptr)==buffers.end();
+    for(const SvarFunction* overload=this;overload;
+        overload=overload->next.isFunction()?&overload->next.as<SvarFunction>():nullptr){
+        if(overload->do_argcheck&&overload->kwargs.empty()&&overload->arg_types.size()!=columns.size()+1)
+            continue;// never called with these rows
+        const batch_kernel* kernel=overload->_batch;
+        if(!kernel||kernel->args.size()!=columns.size()) break;
+        std::vector<char*>   in(columns.size());
+        std::vector<ssize_t> steps(columns.size());
+        std::vector<std::vector<char> > converted(columns.size());
+        bool match=true;
+        for(size_t c=0;match&&c<columns.size();c++){
+            size_t size=kernel->arg_sizes[c];
+            auto unbox=kernel->unbox[c];
+            const SvarBuffer* b=buffers[c];
+            if(b&&b->_format.size()==1&&b->_format[0]==kernel->args[c]&&detail::buffer_step(*b,steps[c])){
+                in[c]=b->ptr<char>();
+                continue;
+            }
+            if(b){
+                converted[c].resize(rows*size);
+                for(size_t r=0;match&&r<rows;r++)
+                    match=unbox(detail::buffer_item(*b,r),&converted[c][r*size]);
+                steps[c]=size;
+            }
+            else if(arrays[c]){
+                std::unique_lock<std::mutex> lock(arrays[c]->_mutex);
+                const std::vector<Svar>& items=arrays[c]->_var;
+                if(items.size()!=rows) throw SvarExeption("callBatch column "+std::to_string(c)+" changed length.");
+                converted[c].resize(rows*size);
+                for(size_t r=0;match&&r<rows;r++)
+                    match=unbox(items[r],&converted[c][r*size]);
+                steps[c]=size;
+            }
+            else{
+                converted[c].resize(size);
+                match=unbox(columns[c],converted[c].data());
+                steps[c]=0;
+            }
+            in[c]=converted[c].data();
+        }
+        if(!match) break;
+
+        // results of buffers are returned as a buffer, of arrays as an array
+        Svar ret=Svar::Undefined();
+        std::vector<char> output;
+        char* out=nullptr;
+        if(all_buffers&&kernel->result){
+            SvarBuffer result(rows*kernel->result_size);
+            result._format=std::string(1,kernel->result);
+            result.shape=buffers[0]->shape;
+            result.strides.resize(result.shape.size());
+            ssize_t stride=kernel->result_size;
+            for(size_t d=result.shape.size();d-->0;){
+                result.strides[d]=stride;
+                stride*=result.shape[d];
+            }
+            out=result.ptr<char>();
+            ret=result;
+        }
+        else if(kernel->result){
+            output.resize(rows*kernel->result_size);
+            out=output.data();
+        }
+
+        // exceptions thrown on the workers are rethrown here
+        size_t chunks=std::max<size_t>(1,std::min<size_t>(threads>1?threads:1,rows));
+        std::vector<std::exception_ptr> errors(chunks);
+        auto run=[&](size_t i){
+            try{
+                kernel->loop(overload->_raw.get(),in.data(),steps.data(),out,rows*i/chunks,rows*(i+1)/chunks);
+            }
+            catch(...){
+                errors[i]=std::current_exception();
+            }
+        };
+        detail::worker_pool::parallel_for(chunks,run);
+        for(std::exception_ptr& e:errors)
+            if(e) std::rethrow_exception(e);
+        if(all_buffers) return ret;
+
+        std::vector<Svar> results(rows);
+        if(kernel->box)
+            for(size_t r=0;r<rows;r++) results[r]=kernel->box(out+r*kernel->result_size);
+        return Svar(std::move(results));
+    }
+
+    // the items are copied as the calls may change the arrays
+    std::vector<std::vector<Svar> > items(columns.size());
+    for(size_t c=0;c<columns.size();c++){
+        if(!arrays[c]) continue;
+        std::unique_lock<std::mutex> lock(arrays[c]->_mutex);
+        items[c]=arrays[c]->_var;
+        if(items[c].size()!=rows) throw SvarExeption("callBatch column "+std::to_string(c)+" changed length.");
+    }
+
+    // every row is dispatched, rows of other types may take another overload
+    std::vector<Svar> results;
+    results.reserve(rows);
+    SvarArgs args;
+    for(size_t r=0;r<rows;r++){
+        args.clear();
+        for(size_t c=0;c<columns.size();c++){
+            if(buffers[c]) args.push_back(detail::buffer_item(*buffers[c],r));
+            else if(arrays[c]) args.push_back(items[c][r]);
+            else args.push_back(columns[c]);
+        }
+        results.push_back(Call(args));
+    }
+    return Svar(std::move(results));
+}
+
+inline Svar SvarFunction::profile(){
+    double tick_ns=detail::call_stats::tick_ns();
+    std::vector<Svar> report;
+    detail::call_stats::for_each([&](const detail::call_stats& s){
+        uint64_t calls=s.calls.load(std::memory_order_relaxed),timed=s.timed.load(std::memory_order_relaxed);
+        if(!calls||!timed) return;
+        const SvarFunction* f=s.owner();
+        double mean=s.total.load(std::memory_order_relaxed)*tick_ns/timed;
+        report.push_back(Svar::object({{"name",f->name.empty()?f->signature():f->name},
+                                       {"calls",(int64_t)calls},
+                                       {"timed",(int64_t)timed},
+                                       {"total_ns",mean*calls},
+                                       {"mean_ns",mean},
+                                       {"max_ns",s.max.load(std::memory_order_relaxed)*tick_ns},
+                                       {"misses",(int64_t)s.misses.load(std::memory_order_relaxed)},
+                                       {"exceptions",(int64_t)s.exceptions.load(std::memory_order_relaxed)}}));
+    });
+    std::sort(report.begin(),report.end(),[](const Svar& a,const Svar& b){
+        return a["total_ns"].as<double>()>b["total_ns"].as<double>();
+    });
+    return Svar(std::move(report));
+}
+
 inline void SvarFunction::process_extra(Svar extra)
 {
     if(extra.is<std::string>())
@@ -2805,40 +4823,91 @@ inline void SvarFunction::process_extra(Svar extra)
 }
 
 inline SvarClass::SvarClass(const std::string& name,std::type_index cpp_type,
-          std::vector<Svar> parents)
+          std::vector<Svar> parents,value_t json_type)
     : __name__(name),_cpptype(cpp_type),
-      _attr(Svar::object()),_parents(parents),_json_type(value_t::others_t){
-
-    std::map<std::type_index,value_t> lut =
-    {{typeid(void),undefined_t},
-     {typeid(nullptr),null_t},
-     {typeid(bool),boolean_t},
-     {typeid(int),value_t::integer_t},
-     {typeid(double),value_t::float_t},
-     {typeid(std::string),value_t::string_t},
-     {typeid(SvarArray),value_t::array_t},
-     {typeid(SvarObject),value_t::object_t},
-     {typeid(SvarDict),value_t::dict_t},
-     {typeid(SvarBuffer),value_t::buffer_t},
-     {typeid(SvarFunction),value_t::function_t},
-     {typeid(SvarClass),value_t::svarclass_t},
-     {typeid(SvarProperty),value_t::property_t},
-     {typeid(arg),value_t::argument_t},
-     {typeid(SvarExeption),value_t::exception_t}
-    };
-    auto it=lut.find(cpp_type);
-    if(it!=lut.end()) _json_type=it->second;
+      _parents(parents),_json_type(json_type),
+      _id(detail::class_table::global().insert(this)),_named(!name.empty()),
+      _attr(Svar::object()){
+    if(!name.empty()) _cast_key=SvarKey("__"+name+"__");
+}
+
+inline SvarClass::SvarClass(const SvarClass& rh)
+    : __name__(rh.name()),__doc__(rh.__doc__),_cpptype(rh._cpptype),
+      __init__(rh.__init__),__str__(rh.__str__),
+      __getitem__(rh.__getitem__),__setitem__(rh.__setitem__),
+      _parents(rh._parents),_json_type(rh._json_type),
+      _id(detail::class_table::global().insert(this)),_named(true),
+      _cast_key("__"+__name__+"__"),_attr(rh._attr){
+}
+
+inline const SvarClass::method_table& SvarClass::rebuild_methods()const{
+    std::unique_lock<std::mutex> lock(_methods_mutex);
+    const method_table* current=_methods.load(std::memory_order_acquire);
+    if(current&&!current->outdated()) return *current;
+
+    std::unique_ptr<method_table> table(new method_table());
+    collect_methods(*table,std::vector<Svar>(),false);
+    if(current) _retired++;
+    _method_tables.push_back(std::move(table));
+    _methods.store(_method_tables.back().get());
+    return *_method_tables.back();
+}
+
+inline void SvarClass::collect_methods(method_table& table,const std::vector<Svar>& casters,bool inherited)const{
+    // read the version first, a concurrent def makes the table outdated instead of being lost
+    table.versions.push_back(std::make_pair(this,_version.load(std::memory_order_acquire)));
+    if(_attr.isObject()){
+        for(const auto& it:_attr.items(true)){
+            size_t i=table.entries.size();
+            auto found=table.index.find(it.first);
+            if(found==table.index.end())
+                table.index[it.first]=i;
+            else{
+                method* last=&table.entries[found->second];
+                while(last->next!=method_table::npos) last=&table.entries[last->next];
+                last->next=i;
+            }
+            table.entries.push_back(method{it.first,it.second,casters,inherited,method_table::npos});
+        }
+    }
+
+    for(const Svar& p:_parents){
+        if(p.isClass()){
+            p.as<SvarClass>().collect_methods(table,casters,true);
+            continue;
+        }
+        std::vector<Svar> parent_casters=casters;
+        parent_casters.push_back(p[1]);
+        p[0].as<SvarClass>().collect_methods(table,parent_casters,true);
+    }
+}
+
+inline void SvarClass::reclaim()const{
+    // a reader entering now sees the current table only, the replaced ones are unreachable
+    std::vector<std::unique_ptr<method_table> > retired;
+    {
+        std::unique_lock<std::mutex> lock(_methods_mutex);
+        if(_readers.load()||_method_tables.size()<2) return;// the last reader frees them
+        retired.assign(std::make_move_iterator(_method_tables.begin()),
+                       std::make_move_iterator(_method_tables.end()-1));
+        _method_tables.erase(_method_tables.begin(),_method_tables.end()-1);
+        _retired=0;
+    }
 }
 
 inline void SvarClass::make_constructor(sv::Svar fvar){
     SvarFunction& f=fvar.as<SvarFunction>();
+    f._raw_type=nullptr;// self is created here, the callable can not be used directly
+    f._batch=nullptr;
     auto func=f._func;
-    f._func=[this,func](std::vector<Svar>& args)->Svar{
+    f._func=[this,func](SvarArgs& args)->Svar{
         sv::Svar self=sv::Svar::object();
         self.as<SvarObject>()._class=this;
-        std::vector<Svar> args1={self};
-        args1.insert(args1.end(),args.begin(),args.end());
-        func(args1);
+        SvarArgs args1;
+        args1.push_back(self);
+        for(Svar& a:args) args1.push_back(a);
+        if(SvarFunction::is_mismatch(func(args1)))
+            return SvarFunction::mismatch();
         return self;
     };
     f.arg_types.erase(f.arg_types.begin()+1);
@@ -2889,33 +4958,36 @@ template <class T>
 inline Svar Svar::create(const T & t)
 {
     static_assert(!std::is_same<T,Svar>::value,"This should not happen.");
-    return (std::shared_ptr<SvarValue>)std::make_shared<SvarValue_<T>>(t);
+    return (std::shared_ptr<SvarValue>)detail::make_node<SvarValue_<T>>(t);
 }
 
 template <class T>
 inline Svar Svar::create(T && t)
 {
     static_assert(!std::is_same<T,Svar>::value,"This should not happen.");
-    return (std::shared_ptr<SvarValue>)std::make_shared<SvarValue_<typename std::remove_reference<T>::type>>(std::move(t));
+    return (std::shared_ptr<SvarValue>)detail::make_node<SvarValue_<typename std::remove_reference<T>::type>>(std::move(t));
 }
 
 inline Svar::Svar(const std::string& m)
-    :_obj(std::make_shared<SvarValue_<std::string>>(m)){}
+    :_obj(detail::make_node<SvarValue_<std::string>>(m)){}
 
 inline Svar::Svar(std::string&& m)
-    :_obj(std::make_shared<SvarValue_<std::string>>(std::move(m))){}
+    :_obj(detail::make_node<SvarValue_<std::string>>(std::move(m))){}
 
 inline Svar::Svar(bool m)
-    :_obj(std::make_shared<SvarValue_<bool>>(m)){}
+    :_obj(detail::make_node<SvarValue_<bool>>(m)){}
 
 inline Svar::Svar(int m)
-    :_obj(std::make_shared<SvarValue_<int>>(m)){}
+    :_obj(detail::make_node<SvarValue_<int>>(m)){}
+
+inline Svar::Svar(int64_t m)
+    :_obj(detail::make_node<SvarValue_<int64_t>>(m)){}
 
 inline Svar::Svar(double m)
-    :_obj(std::make_shared<SvarValue_<double>>(m)){}
+    :_obj(detail::make_node<SvarValue_<double>>(m)){}
 
 inline Svar::Svar(std::vector<Svar>&& rvec)
-    :_obj(std::make_shared<SvarArray>(rvec)){}
+    :_obj(detail::make_node<SvarArray>(std::move(rvec))){}
 
 template <typename T>
 Svar::Svar(std::unique_ptr<T>&& v)
@@ -2930,7 +5002,12 @@ inline Svar operator"" _svar(const char* str,size_t sz){
 }
 
 template <typename T>
-inline bool Svar::is()const{return _obj->as(typeid(T))!=nullptr;}
+inline bool Svar::is()const{
+    // builtin values are tagged, only wrapped pointers and user types need the virtual lookup
+    if(detail::json_type<T>::value!=others_t&&_obj->_type!=others_t)
+        return _obj->_type==detail::json_type<T>::value;
+    return _obj->as(typeid(T))!=nullptr;
+}
 inline bool Svar::is(const std::type_index& typeId)const{return _obj->as(typeId)!=nullptr;}
 inline bool Svar::is(const std::string& typeStr)const{return classObject().name()==typeStr;}
 
@@ -2942,15 +5019,15 @@ inline bool Svar::isProperty() const{
 }
 
 inline bool Svar::isObject() const{
-    return std::dynamic_pointer_cast<SvarObject>(_obj)!=nullptr;
+    return _obj->_type==object_t;
 }
 
 inline bool Svar::isArray()const{
-    return std::dynamic_pointer_cast<SvarArray>(_obj)!=nullptr;
+    return _obj->_type==array_t;
 }
 
 inline bool Svar::isDict()const{
-    return std::dynamic_pointer_cast<SvarDict>(_obj)!=nullptr;
+    return _obj->_type==dict_t;
 }
 
 template <typename T>
@@ -2997,8 +5074,8 @@ public:
     static Svar from(const Svar& var){
         if(var.is<T>()) return var;
 
-        SvarClass& srcClass=var.classObject();
-        Svar cvt=srcClass._attr["__"+SvarClass::Class<T>().name()+"__"];
+        const Svar& srcAttr=var.classObject().attributes();
+        Svar cvt=srcAttr[SvarClass::Class<T>().castKey()];
         if(cvt.isFunction()){
             Svar ret=cvt(var);
             if(ret.is<T>()) return ret;
@@ -3092,8 +5169,90 @@ inline Svar Svar::castAs<Svar>()const{
     return *this;
 }
 
+template <>
+inline int Svar::castAs<int>()const{
+    int ret;
+    if(detail::number_cast(_obj.get(),ret)) return ret;
+    Svar cvt=caster<int>::from(*this);
+    if(!cvt.is<int>())
+        throw SvarExeption("Unable cast "+typeName()+" to int");
+    return cvt.as<int>();
+}
+
+template <>
+inline int64_t Svar::castAs<int64_t>()const{
+    int64_t ret;
+    if(detail::number_cast(_obj.get(),ret)) return ret;
+    Svar cvt=caster<int64_t>::from(*this);
+    if(!cvt.is<int64_t>())
+        throw SvarExeption("Unable cast "+typeName()+" to int64_t");
+    return cvt.as<int64_t>();
+}
+
+template <>
+inline double Svar::castAs<double>()const{
+    double ret;
+    if(detail::number_cast(_obj.get(),ret)) return ret;
+    Svar cvt=caster<double>::from(*this);
+    if(!cvt.is<double>())
+        throw SvarExeption("Unable cast "+typeName()+" to double");
+    return cvt.as<double>();
+}
+
+template <>
+inline bool Svar::castAs<bool>()const{
+    bool ret;
+    if(detail::number_cast(_obj.get(),ret)) return ret;
+    Svar cvt=caster<bool>::from(*this);
+    if(!cvt.is<bool>())
+        throw SvarExeption("Unable cast "+typeName()+" to bool");
+    return cvt.as<bool>();
+}
+
 inline Svar Svar::clone(int depth)const{return _obj->clone(depth);}
 
+inline Svar SvarArena::stats(){
+    size_t pool_allocs,pool_frees,arena_allocs,heap_allocs;
+    detail::alloc_stats::sum(pool_allocs,pool_frees,arena_allocs,heap_allocs);
+    return {{"pool_allocs",(int64_t)pool_allocs},
+            {"pool_live",(int64_t)(pool_allocs-pool_frees)},
+            {"pool_bytes",(int64_t)detail::alloc_stats::pool_bytes().load()},
+            {"arena_allocs",(int64_t)arena_allocs},
+            {"arena_regions",(int64_t)detail::alloc_stats::arena_regions().load()},
+            {"arena_bytes",(int64_t)detail::alloc_stats::arena_bytes().load()},
+            {"heap_allocs",(int64_t)heap_allocs}};
+}
+
+inline size_t Svar::hash()const{
+    switch(_obj->_type){
+    case boolean_t:
+    case integer_t:
+        return std::hash<long long>()(castAs<int>());
+    case integer64_t:
+        return std::hash<long long>()(unsafe_as<int64_t>());
+    case float_t:{
+        double d=unsafe_as<double>();
+        if(d>=-9e18&&d<=9e18&&d==(double)(long long)d)
+            return std::hash<long long>()((long long)d);
+        return std::hash<double>()(d);
+    }
+    case string_t:
+        return std::hash<std::string>()(unsafe_as<std::string>());
+    case undefined_t:
+    case null_t:
+        return 0;
+    default:
+        break;
+    }
+    const SvarClass& cls=classObject();
+    Svar hash_func=cls["__hash__"];
+    if(hash_func.isFunction()) return hash_func(*this).castAs<int>();
+    // the address only agrees with the identity compare, values equal by __eq__ need __hash__
+    if(cls["__eq__"].isFunction())
+        throw SvarExeption("unhashable type: "+typeName()+" defines __eq__ but not __hash__");
+    return std::hash<const void*>()(_obj.get());
+}
+
 inline std::string Svar::typeName()const{
     return classObject().name();
 }
@@ -3104,7 +5263,10 @@ inline SvarValue::TypeID Svar::cpptype()const{
 
 inline value_t           Svar::jsontype()const
 {
-    return classObject()._json_type;
+    value_t type=_obj->_type;
+    // objects may be instances of a dynamic class, see SvarClass::make_constructor
+    if(type==others_t||type==object_t) return classObject()._json_type;
+    return type;
 }
 
 inline SvarClass&       Svar::classObject()const{
@@ -3121,7 +5283,7 @@ inline Svar Svar::operator[](const Svar& i) const{
         return cl.__getitem__((*this),i);
     }
     if(!i.is<std::string>()) return Undefined();
-    Svar property=cl._attr[i.as<std::string>()];
+    Svar property=cl.attributes()[i.as<std::string>()];
     if(property.isProperty()){
         return property.as<SvarClass::SvarProperty>()._fget(*this);
     }
@@ -3136,16 +5298,8 @@ inline Svar& Svar::operator[](const Svar& name){
         *this=object();
     }
 
-    if(isObject()){
-        SvarObject& obj=as<SvarObject>();
-        std::string nameStr=name.as<std::string>();
-        std::unique_lock<std::mutex> lock(obj._mutex);
-        auto it=obj._var.find(nameStr);
-        if(it!=obj._var.end())
-            return it->second;
-        auto ret=obj._var.insert(std::make_pair(nameStr,Svar()));
-        return ret.first->second;
-    }
+    if(isObject())
+        return (*this)[SvarKey(name.as<std::string>())];
     else if(isArray())
         return as<SvarArray>()._var[name.castAs<int>()];
     else if(isDict())
@@ -3154,6 +5308,29 @@ inline Svar& Svar::operator[](const Svar& name){
     return *this;
 }
 
+inline Svar Svar::operator[](const SvarKey& key) const{
+    if(isObject()&&!as<SvarObject>()._class)
+        return as<SvarObject>()[key];
+    return (*this)[Svar(key.str())];
+}
+
+inline Svar& Svar::operator[](const SvarKey& key){
+    if(isUndefined()) {
+        *this=object();
+    }
+
+    if(!isObject())
+        return (*this)[Svar(key.str())];
+
+    SvarObject& obj=as<SvarObject>();
+    std::unique_lock<std::mutex> lock(obj._mutex);
+    auto it=obj._var.find(key);
+    if(it!=obj._var.end())
+        return it->second;
+    auto ret=obj._var.insert(std::make_pair(key,Svar()));
+    return ret.first->second;
+}
+
 template <typename T>
 T Svar::get(const std::string& name,T def,bool parse_dot){
     if(parse_dot){
@@ -3163,6 +5340,11 @@ T Svar::get(const std::string& name,T def,bool parse_dot){
         }
     }
 
+    return get(SvarKey(name),def);
+}
+
+template <typename T>
+T Svar::get(const SvarKey& name,T def){
     Svar var;
     if(isObject())
     {
@@ -3174,16 +5356,16 @@ T Svar::get(const std::string& name,T def,bool parse_dot){
     else {
         const SvarClass& cl=classObject();
         if(cl.__getitem__.isFunction()){
-            Svar ret=cl.__getitem__((*this),name);
+            Svar ret=cl.__getitem__((*this),name.str());
             return ret.as<T>();
         }
-        Svar property=cl._attr[name];
+        Svar property=cl.attributes()[name];
         if(property.isProperty()){
             Svar ret=property.as<SvarClass::SvarProperty>()._fget(*this);
             return ret.as<T>();
         }
         else{
-            throw SvarExeption(typeName()+": get called without property "+name);
+            throw SvarExeption(typeName()+": get called without property "+name.str());
         }
     }
 
@@ -3208,8 +5390,14 @@ inline void Svar::set(const std::string& name,const T& def,bool parse_dot){
             return (*this)[name.substr(0, idx)].set(name.substr(idx + 1), def, parse_dot);
         }
     }
+    set(SvarKey(name),def);
+}
+
+template <typename T>
+inline void Svar::set(const SvarKey& name,const T& def){
     if(isUndefined()){
-        *this=object({{name,def}});
+        *this=object();
+        as<SvarObject>().set(name,def);
         return;
     }
     if(isObject()){
@@ -3222,15 +5410,15 @@ inline void Svar::set(const std::string& name,const T& def,bool parse_dot){
     }
     const SvarClass& cl=classObject();
     if(cl.__setitem__.isFunction()){
-        cl.__setitem__((*this),name,def);
+        cl.__setitem__((*this),name.str(),def);
         return;
     }
-    Svar property=cl._attr[name];
+    Svar property=cl.attributes()[name];
     if(!property.isProperty())
-        throw SvarExeption(typeName()+": set called without property "+name);
+        throw SvarExeption(typeName()+": set called without property "+name.str());
 
     Svar fset=property.as<SvarClass::SvarProperty>()._fset;
-    if(!fset.isFunction()) throw SvarExeption(typeName()+": property "+name+" is readonly.");
+    if(!fset.isFunction()) throw SvarExeption(typeName()+": property "+name.str()+" is readonly.");
     fset(*this,def);
 }
 
@@ -3256,6 +5444,7 @@ Svar Svar::def(const std::string& name, Svar func, const Extra&... extra){
     std::vector<Svar> extras={extra...};
     for(Svar e:extras)
         func.as<SvarFunction>().process_extra(e);
+    if(func.as<SvarFunction>().name.empty()) func.as<SvarFunction>().name=name;// reported by SvarFunction::profile
     (*this)[name] = func;
     return (*this);
 }
@@ -3272,6 +5461,41 @@ Svar Svar::call(const std::string function, Args... args)const
     return classObject().call(*this,function,args...);
 }
 
+/// Inline cache for calling a method by name, keep one at the call site:
+///   static CallSite area("area");
+///   double a=area(shape).as<double>();// same as shape.call("area")
+/// The method found for the last class is reused while that class and its parents are unchanged.
+class CallSite{
+public:
+    explicit CallSite(const std::string& name):_name(name),_cached(nullptr){}
+
+    const std::string& name()const{return _name;}
+
+    template <typename... Args>
+    Svar operator()(const Svar& inst,Args... args)const{
+        bool is_class=inst.isClass();
+        const SvarClass& cls=is_class?inst.as<SvarClass>():inst.classObject();
+        SvarClass::method_reader table(cls);
+        const SvarClass::method* m=_cached.load(std::memory_order_acquire);
+        // the name check catches a freed table whose memory is reused by another one
+        if(!m||!table->owns(m)||m->name!=_name){
+            m=table->find(_name);
+            if(!m)
+                throw SvarExeption("Class "+cls.name()+" has no function "+_name);
+            _cached.store(m,std::memory_order_release);
+        }
+
+        SvarArgs argv;
+        int expand[]={0,(argv.emplace_back(std::move(args)),0)...};
+        (void)expand;
+        return cls.invoke(*table,*m,is_class?Svar():inst,argv);// classes call static methods
+    }
+
+private:
+    std::string                                     _name;
+    mutable std::atomic<const SvarClass::method*>   _cached;
+};
+
 template <typename... Args>
 Svar Svar::operator()(Args... args)const{
     if(isFunction())
@@ -3279,13 +5503,20 @@ Svar Svar::operator()(Args... args)const{
     else if(isClass()){
         const SvarClass& cls=as<SvarClass>();
         if(!cls.__init__.isFunction())
-            throw SvarExeption("Class "+cls.__name__+" does not have __init__ function.");
+            throw SvarExeption("Class "+cls.name()+" does not have __init__ function.");
         return cls.__init__(args...);
     }
     throw SvarExeption(typeName()+" can't be called as a function or constructor.");
     return Undefined();
 }
 
+template <typename R,typename... Args>
+TypedFunction<R(Args...)>::TypedFunction(const Svar& func)
+    :_func(func),_raw(nullptr){
+    if(func.isFunction())
+        _raw=func.as<SvarFunction>().raw<R,Args...>();
+}
+
 struct pagedostream{
     pagedostream():page_size(4096){
         pages.push_back(std::string());
@@ -3381,7 +5612,7 @@ T& Svar::dump(T& o,const int indent_step,const int current_indent)const
         out+='"';
         return out;
     };
-    switch(classObject()._json_type)
+    switch(jsontype())
     {
     case value_t::null_t:
         return o<<"null";
@@ -3393,11 +5624,13 @@ T& Svar::dump(T& o,const int indent_step,const int current_indent)const
     }
     case value_t::integer_t:
         return o<<std::to_string(unsafe_as<int>());
+    case value_t::integer64_t:
+        return o<<std::to_string(unsafe_as<int64_t>());
     case value_t::string_t:
         return o<<dump_str(unsafe_as<std::string>());
     case value_t::array_t:
     {
-        const std::vector<Svar>& vec=unsafe_as<std::vector<Svar>>();
+        const std::vector<Svar>& vec=as<SvarArray>()._var;
         const auto N = vec.size();
         if(N==0)
             return o<<"[]";
@@ -3424,7 +5657,7 @@ T& Svar::dump(T& o,const int indent_step,const int current_indent)const
     }
     case value_t::object_t:
     {
-        const auto& obj=unsafe_as<std::unordered_map<std::string,Svar>>();
+        const auto& obj=as<SvarObject>()._var;
         const auto N = obj.size();
         if(N==0) return o<<"{}";
         o<<'{';
@@ -3707,44 +5940,266 @@ inline std::string Svar::printTable(
   return sst.str();
 }
 
+namespace detail {
+/// Result of int arithmetic, promoted to int64_t when it overflows int
+inline Svar integer(int64_t v){
+    if(v>=std::numeric_limits<int>::min()&&v<=std::numeric_limits<int>::max()) return (int)v;
+    return v;
+}
+
+template <typename T>
+inline const T& value_of(const SvarValue* v){return static_cast<const SvarValue_<T>*>(v)->_var;}
+
+inline bool is_number(const SvarValue* v){
+    return v->_type==integer_t||v->_type==integer64_t||v->_type==float_t;
+}
+
+inline bool is_plain_object(const SvarValue* v){
+    return v->_type==object_t&&!static_cast<const SvarObject*>(v)->_class;
+}
+
+inline Svar array_add(const SvarArray& self,const SvarArray& rh){
+    std::vector<Svar> ret;
+    {
+        std::unique_lock<std::mutex> lock(self._mutex);
+        ret=self._var;
+    }
+    std::unique_lock<std::mutex> lock(rh._mutex);
+    ret.insert(ret.end(),rh._var.begin(),rh._var.end());
+    return ret;
+}
+
+inline Svar array_mul(const SvarArray& self,const int& num){
+    std::unique_lock<std::mutex> lock(self._mutex);
+    std::vector<Svar> ret;
+    if(num>0) ret.reserve(self._var.size()*num);
+    for(int i=0;i<num;++i)
+        ret.insert(ret.end(),self._var.begin(),self._var.end());
+    return ret;
+}
+
+/// Merge two objects, members of self win
+inline Svar object_add(const SvarObject& self,const SvarObject& rh){
+    std::unique_lock<std::mutex> lock1(self._mutex);
+    auto ret=self._var;
+    if(&self!=&rh){
+        std::unique_lock<std::mutex> lock2(rh._mutex);
+        for(auto it:rh._var){
+            if(ret.find(it.first)==ret.end())
+                ret.insert(it);
+        }
+    }
+    return (std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::move(ret));
+}
+
+// checked() computes int64_t results, it returns false instead of overflowing
+struct op_add{
+    template <typename T> static T apply(T a,T b){return a+b;}
+    static bool checked(int64_t a,int64_t b,int64_t& r){
+        if((b>0&&a>std::numeric_limits<int64_t>::max()-b)||(b<0&&a<std::numeric_limits<int64_t>::min()-b)) return false;
+        r=a+b;
+        return true;
+    }
+};
+struct op_sub{
+    template <typename T> static T apply(T a,T b){return a-b;}
+    static bool checked(int64_t a,int64_t b,int64_t& r){
+        if((b<0&&a>std::numeric_limits<int64_t>::max()+b)||(b>0&&a<std::numeric_limits<int64_t>::min()+b)) return false;
+        r=a-b;
+        return true;
+    }
+};
+struct op_mul{
+    template <typename T> static T apply(T a,T b){return a*b;}
+    static bool checked(int64_t a,int64_t b,int64_t& r){
+        const int64_t max=std::numeric_limits<int64_t>::max(),min=std::numeric_limits<int64_t>::min();
+        if(a>0?(b>0?a>max/b:b<min/a):(b>0?a<min/b:(a!=0&&b<max/a))) return false;
+        r=a*b;
+        return true;
+    }
+};
+struct op_div{
+    template <typename T> static T apply(T a,T b){return a/b;}
+    static bool checked(int64_t a,int64_t b,int64_t& r){
+        if(b==0||(b==-1&&a==std::numeric_limits<int64_t>::min())) return false;
+        r=a/b;
+        return true;
+    }
+};
+struct op_mod{template <typename T> static T apply(T a,T b){return a%b;}};
+struct op_xor{template <typename T> static T apply(T a,T b){return a^b;}};
+struct op_or {template <typename T> static T apply(T a,T b){return a|b;}};
+struct op_and{template <typename T> static T apply(T a,T b){return a&b;}};
+
+/// Result of int64_t arithmetic, promoted to double when it overflows int64_t as int is promoted to int64_t
+template <typename Op>
+inline Svar integer64(int64_t a,int64_t b){
+    int64_t r;
+    if(Op::checked(a,b,r)) return r;
+    return Op::apply((double)a,(double)b);
+}
+
+/// Arithmetic of the builtin numbers dispatched by type tags, same results as the
+/// __add__, __sub__, __mul__ and __div__ of int, int64_t and double.
+/// int op int is done in int64_t and promoted when Promote, otherwise stays int.
+template <typename Op,bool Promote>
+struct builtin_number{
+    static bool accepts(const SvarValue* l,const SvarValue* r){return is_number(l)&&is_number(r);}
+
+    static Svar apply(const SvarValue* l,const SvarValue* r){
+        if(l->_type==float_t||r->_type==float_t){
+            double a,b;
+            number_cast(l,a);number_cast(r,b);
+            return Op::apply(a,b);
+        }
+        if(l->_type==integer_t&&r->_type==integer_t){
+            if(Promote) return integer(Op::apply((int64_t)value_of<int>(l),(int64_t)value_of<int>(r)));
+            return Op::apply(value_of<int>(l),value_of<int>(r));
+        }
+        int64_t a,b;
+        number_cast(l,a);number_cast(r,b);
+        return integer64<Op>(a,b);
+    }
+};
+
+/// %, ^, | and & of the builtin integers: int with int, int64_t with int or int64_t
+template <typename Op>
+struct builtin_integral{
+    static bool accepts(const SvarValue* l,const SvarValue* r){
+        if(l->_type==integer_t) return r->_type==integer_t;
+        return l->_type==integer64_t&&(r->_type==integer_t||r->_type==integer64_t);
+    }
+
+    static Svar apply(const SvarValue* l,const SvarValue* r){
+        if(l->_type==integer_t) return Op::apply(value_of<int>(l),value_of<int>(r));
+        int64_t b;
+        number_cast(r,b);
+        if(std::is_same<Op,op_mod>::value&&b==-1) return (int64_t)0;// min%-1 overflows
+        return Op::apply(value_of<int64_t>(l),b);
+    }
+};
+
+typedef builtin_number<op_sub,true>  builtin_sub;
+typedef builtin_number<op_div,false> builtin_div;
+typedef builtin_integral<op_mod>     builtin_mod;
+typedef builtin_integral<op_xor>     builtin_xor;
+typedef builtin_integral<op_or>      builtin_or;
+typedef builtin_integral<op_and>     builtin_and;
+
+/// Numbers, plus concatenation of strings and arrays and merging of plain objects
+struct builtin_add : public builtin_number<op_add,true>{
+    static bool accepts(const SvarValue* l,const SvarValue* r){
+        if(is_number(l)) return is_number(r);
+        if(l->_type!=r->_type) return false;
+        return l->_type==string_t||l->_type==array_t||(is_plain_object(l)&&is_plain_object(r));
+    }
+
+    static Svar apply(const SvarValue* l,const SvarValue* r){
+        switch(l->_type){
+        case string_t: return value_of<std::string>(l)+value_of<std::string>(r);
+        case array_t:  return array_add(*static_cast<const SvarArray*>(l),*static_cast<const SvarArray*>(r));
+        case object_t: return object_add(*static_cast<const SvarObject*>(l),*static_cast<const SvarObject*>(r));
+        default:       return builtin_number<op_add,true>::apply(l,r);
+        }
+    }
+};
+
+/// Numbers, plus repeating an array by an int
+struct builtin_mul : public builtin_number<op_mul,true>{
+    static bool accepts(const SvarValue* l,const SvarValue* r){
+        if(is_number(l)) return is_number(r);
+        return l->_type==array_t&&r->_type==integer_t;
+    }
+
+    static Svar apply(const SvarValue* l,const SvarValue* r){
+        if(l->_type==array_t) return array_mul(*static_cast<const SvarArray*>(l),value_of<int>(r));
+        return builtin_number<op_mul,true>::apply(l,r);
+    }
+};
+
+/// __eq__ and __lt__ of the builtin numbers, bool and str dispatched by type tags.
+/// Returns false when the class protocol should decide.
+/// As __eq__ of int and int64_t, a double on the right is truncated to int64_t.
+inline bool builtin_compare(const SvarValue* l,const SvarValue* r,bool less,bool& result){
+    switch(l->_type){
+    case integer_t:
+    case integer64_t:{
+        if(!is_number(r)) return false;
+        int64_t a,b;
+        number_cast(l,a);number_cast(r,b);
+        result=less?a<b:a==b;
+        return true;
+    }
+    case float_t:{
+        if(!is_number(r)) return false;
+        double a,b;
+        number_cast(l,a);number_cast(r,b);
+        result=less?a<b:a==b;
+        return true;
+    }
+    case boolean_t:
+        if(less||r->_type!=boolean_t) return false;
+        result=value_of<bool>(l)==value_of<bool>(r);
+        return true;
+    case string_t:
+        if(r->_type!=string_t) return false;
+        result=less?value_of<std::string>(l)<value_of<std::string>(r):
+                    value_of<std::string>(l)==value_of<std::string>(r);
+        return true;
+    default:
+        return false;
+    }
+}
+}
+
 inline Svar Svar::operator -()const
 {
-    return classObject().call(*this,"__neg__");
+    switch(_obj->_type){
+    case integer_t:   return detail::integer(-(int64_t)detail::value_of<int>(_obj.get()));
+    case integer64_t: return detail::integer64<detail::op_sub>(0,detail::value_of<int64_t>(_obj.get()));
+    case float_t:     return -detail::value_of<double>(_obj.get());
+    default:          return classObject().call(*this,"__neg__");
+    }
 }
 
-#define DEF_SVAR_OPERATOR_IMPL(SNAME)\
+/// Builtin types are dispatched by type tags with FAST, others through the class protocol
+#define DEF_SVAR_OPERATOR_IMPL(SNAME,FAST)\
 {\
+    const SvarValue *l=_obj.get(),*r=rh.value().get();\
+    if(detail::FAST::accepts(l,r)) return detail::FAST::apply(l,r);\
     auto& cls=classObject();\
     Svar ret=cls.call(*this,#SNAME,rh);\
-    if(ret.isUndefined()) throw SvarExeption(cls.__name__+" operator "#SNAME" with rh: "+rh.typeName()+"returned Undefined.");\
+    if(ret.isUndefined()) throw SvarExeption(cls.name()+" operator "#SNAME" with rh: "+rh.typeName()+"returned Undefined.");\
     return ret;\
 }
 
 inline Svar Svar::operator +(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__add__)
+DEF_SVAR_OPERATOR_IMPL(__add__,builtin_add)
 
 inline Svar Svar::operator -(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__sub__)
+DEF_SVAR_OPERATOR_IMPL(__sub__,builtin_sub)
 
 inline Svar Svar::operator *(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__mul__)
+DEF_SVAR_OPERATOR_IMPL(__mul__,builtin_mul)
 
 inline Svar Svar::operator /(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__div__)
+DEF_SVAR_OPERATOR_IMPL(__div__,builtin_div)
 
 inline Svar Svar::operator %(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__mod__)
+DEF_SVAR_OPERATOR_IMPL(__mod__,builtin_mod)
 
 inline Svar Svar::operator ^(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__xor__)
+DEF_SVAR_OPERATOR_IMPL(__xor__,builtin_xor)
 
 inline Svar Svar::operator |(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__or__)
+DEF_SVAR_OPERATOR_IMPL(__or__,builtin_or)
 
 inline Svar Svar::operator &(const Svar& rh)const
-DEF_SVAR_OPERATOR_IMPL(__and__)
+DEF_SVAR_OPERATOR_IMPL(__and__,builtin_and)
 
 inline bool Svar::operator ==(const Svar& rh)const{
+    bool result;
+    if(detail::builtin_compare(_obj.get(),rh.value().get(),false,result)) return result;
     Svar eq_func=classObject()["__eq__"];
     if(!eq_func.isFunction()) return _obj==rh.value();
     Svar ret=eq_func(*this,rh);
@@ -3753,6 +6208,8 @@ inline bool Svar::operator ==(const Svar& rh)const{
 }
 
 inline bool Svar::operator <(const Svar& rh)const{
+    bool result;
+    if(detail::builtin_compare(_obj.get(),rh.value().get(),true,result)) return result;
     Svar lt_func=classObject()["__lt__"];
     if(!lt_func.isFunction()) return _obj==rh.value();
     Svar ret=lt_func(*this,rh);
@@ -3766,10 +6223,19 @@ inline std::ostream& operator <<(std::ostream& ost,const Svar& self)
 }
 
 inline const Svar& Svar::Undefined(){
-    static Svar v(std::make_shared<SvarValue>());
+    static Svar v(std::make_shared<SvarValue>(undefined_t));
+    return v;
+}
+
+inline const Svar& SvarFunction::mismatch(){
+    static Svar v=Svar::create(detail::arg_mismatch());
     return v;
 }
 
+inline bool SvarFunction::is_mismatch(const Svar& ret){
+    return ret.value()->_type==others_t&&ret.is<detail::arg_mismatch>();
+}
+
 inline const Svar& Svar::Null()
 {
     static Svar v=create<std::nullptr_t>(nullptr);
@@ -3819,67 +6285,36 @@ inline Svar  Svar::loadFile(const std::string& file_path)
     return Svar::Undefined();
 }
 
-inline Svar::svar_interator::svar_interator(Svar it,Svar::svar_interator::IterType tp)
-    :_it(new Svar(it)),_type(tp)
-{}
-
-inline Svar Svar::svar_interator::operator*(){
-    typedef std::vector<Svar>::const_iterator array_iter;
-    typedef std::unordered_map<std::string,Svar>::const_iterator object_iter;
-    switch (_type) {
-    case Object: return *_it->as<object_iter>();break;
-    case Array: return *_it->as<array_iter>();break;
-    default:  return *_it;
-    }
-}
-
-inline Svar::svar_interator& Svar::svar_interator::operator++()
-{
-    typedef std::vector<Svar>::const_iterator array_iter;
-    typedef std::unordered_map<std::string,Svar>::const_iterator object_iter;
-    switch (_type)
-    {
-    case Object: _it->as<object_iter>()++;break;
-    case Array: _it->as<array_iter>()++;break;
-    default: break;
-    }
-    return *this;
-}
-
-inline bool Svar::svar_interator::operator==(const svar_interator& other) const
-{
-    typedef std::vector<Svar>::const_iterator array_iter;
-    typedef std::unordered_map<std::string,Svar>::const_iterator object_iter;
-    switch (_type)
-    {
-    case Object: return _it->as<object_iter>()==other._it->as<object_iter>();
-    case Array: return _it->as<array_iter>()==other._it->as<array_iter>();
-    default: return _it==other._it;break;
-    }
-}
-
 inline Svar::svar_interator Svar::begin()const
 {
-    if(isObject()) return svar_interator(as<SvarObject>()._var.begin(),svar_interator::Object);
-    else if(isArray()) return svar_interator(as<SvarArray>()._var.begin(),svar_interator::Array);
-    return svar_interator(*this,svar_interator::Others);
+    if(isObject()) return as<SvarObject>()._var.begin();
+    else if(isArray()) return as<SvarArray>()._var.begin();
+    return svar_interator();
 }
 
 inline Svar::svar_interator Svar::end()const
 {
-    if(isObject()) return svar_interator(as<SvarObject>()._var.end(),svar_interator::Object);
-    else if(isArray()) return svar_interator(as<SvarArray>()._var.end(),svar_interator::Array);
-    return svar_interator(*this,svar_interator::Others);
+    if(isObject()) return as<SvarObject>()._var.end();
+    else if(isArray()) return as<SvarArray>()._var.end();
+    return svar_interator();
 }
 
 inline Svar::svar_interator Svar::find(const Svar& idx)const
 {
-    if(isObject()) return svar_interator(as<SvarObject>()._var.find(idx.castAs<std::string>()),svar_interator::Object);
+    if(isObject()) return as<SvarObject>()._var.find(SvarKey(idx.castAs<std::string>()));
     return end();
 }
 
+inline Svar::items_view Svar::items(bool lock)const{
+    return items_view(*this,lock);
+}
+
+inline Svar::values_view Svar::values(bool lock)const{
+    return values_view(*this,lock);
+}
+
 inline std::ostream& operator<<(std::ostream& ost,const SvarClass& rh){
-    ost<<"class "<<rh.__name__<<"():\n";
+    ost<<"class "<<rh.name()<<"():\n";
     std::stringstream  content;
     if(!rh.__doc__.empty()) content<<rh.__doc__<<std::endl;
     if(rh._attr.isObject()&&rh._attr.length()){
@@ -3920,7 +6355,7 @@ public:
     }
 
     static Svar to(const std::vector<T>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarArray>(std::vector<Svar>(var.begin(),var.end()));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarArray>(std::vector<Svar>(var.begin(),var.end()));
     }
 };
 
@@ -3933,11 +6368,11 @@ public:
     }
 
     static Svar to(const std::vector<Svar>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarArray>(var);
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarArray>(var);
     }
 
     static Svar to(std::vector<Svar>&& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarArray>(std::move(var));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarArray>(std::move(var));
     }
 };
 
@@ -3959,7 +6394,7 @@ public:
     }
 
     static Svar to(const std::list<T>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarArray>(std::vector<Svar>(var.begin(),var.end()));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarArray>(std::vector<Svar>(var.begin(),var.end()));
     }
 };
 
@@ -3972,16 +6407,16 @@ public:
         if(!var.isObject()) return  Svar::Undefined();
 
         std::map<std::string,T> ret;
-        for(const std::pair<std::string,Svar>& v:var.as<SvarObject>()._var)
+        for(const auto& v:var.as<SvarObject>()._var)
         {
-            ret.insert(std::make_pair(v.first,v.second.castAs<T>()));
+            ret.insert(std::make_pair(v.first.str(),v.second.castAs<T>()));
         }
 
         return Svar::create(ret);
     }
 
     static Svar to(const std::map<std::string,T>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarObject>(std::unordered_map<std::string,Svar>(var.begin(),var.end()));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::unordered_map<std::string,Svar>(var.begin(),var.end()));
     }
 };
 
@@ -3994,16 +6429,16 @@ public:
         if(!var.isObject()) return  Svar::Undefined();
 
         std::unordered_map<std::string,T> ret;
-        for(const std::pair<std::string,Svar>& v:var.as<SvarObject>()._var)
+        for(const auto& v:var.as<SvarObject>()._var)
         {
-            ret.insert(std::make_pair(v.first,v.second.castAs<T>()));
+            ret.insert(std::make_pair(v.first.str(),v.second.castAs<T>()));
         }
 
         return Svar::create(ret);
     }
 
     static Svar to(const std::unordered_map<std::string,T>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarObject>(std::unordered_map<std::string,Svar>(var.begin(),var.end()));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::unordered_map<std::string,Svar>(var.begin(),var.end()));
     }
 };
 
@@ -4016,7 +6451,7 @@ public:
         if(!var.isDict()) return  Svar::Undefined();
 
         std::map<K,T> ret;
-        for(const std::pair<Svar,Svar>& v:var.as<SvarObject>()._var)
+        for(const std::pair<const Svar,Svar>& v:var.as<SvarDict>()._var)
         {
             ret.insert(std::make_pair(v.first.castAs<K>(),v.second.castAs<T>()));
         }
@@ -4025,7 +6460,7 @@ public:
     }
 
     static Svar to(const std::map<K,T>& var){
-        return (std::shared_ptr<SvarValue>)std::make_shared<SvarDict>(std::map<Svar,Svar>(var.begin(),var.end()));
+        return (std::shared_ptr<SvarValue>)detail::make_node<SvarDict>(SvarDict::map_type(var.begin(),var.end()));
     }
 };
 
@@ -4075,11 +6510,89 @@ public:
         return Svar();
     }
 
-    static Svar to(const char* v){
-        return std::string(v);
+    static Svar to(const char* v){
+        return std::string(v);
+    }
+};
+
+template <>
+class caster<SvarKey>{
+public:
+    static Svar from(const Svar& var){
+        if(var.is<std::string>())
+            return Svar::create(SvarKey(var.as<std::string>()));
+        return Svar();
+    }
+
+    static Svar to(const SvarKey& v){
+        return v.str();
+    }
+};
+
+namespace detail {
+
+/// Numbers convert directly, see Svar::castAs<int>, castAs<int64_t>, castAs<double> and castAs<bool>
+template <typename T>
+struct is_tagged_number{
+    static constexpr bool value=json_type<T>::value==integer_t||json_type<T>::value==integer64_t||
+                                json_type<T>::value==float_t||json_type<T>::value==boolean_t;
+};
+
+// converted values replace the argument in the scratch, so that castAs<T>() finds T directly
+template <typename T>
+struct arg_caster<T,enable_if_t<!std::is_reference<T>::value&&!std::is_pointer<T>::value> >{
+    static bool convert(SvarArgs& args,size_t i,arg_scratch& scratch){
+        const Svar& var=args[i];
+        if(var.is<T>()) return true;
+        if(is_tagged_number<T>::value){
+            value_t type=var.value()->_type;
+            if(type==integer_t||type==integer64_t||type==float_t||type==boolean_t) return true;
+        }
+        overload_cache::by_value()=true;
+        Svar ret=caster<T>::from(var);
+        if(!ret.is<T>()) return false;
+        scratch.replace(i,std::move(ret));
+        return true;
+    }
+};
+
+// references are never converted, same as castAs<T&>()
+template <typename T>
+struct arg_caster<T,enable_if_t<std::is_reference<T>::value> >{
+    static bool convert(SvarArgs& args,size_t i,arg_scratch&){
+        return args[i].is<typename std::remove_const<typename std::remove_reference<T>::type>::type>();
+    }
+};
+
+template <typename T>
+struct arg_caster<T,enable_if_t<std::is_pointer<T>::value> >{
+    static bool convert(SvarArgs& args,size_t i,arg_scratch& scratch){
+        typedef typename std::remove_const<typename std::remove_pointer<T>::type>::type* rcptr;
+        typedef typename std::remove_pointer<T>::type rpt;
+        const Svar& var=args[i];
+        const SvarValue* v=var.value().get();
+        if(v->as(typeid(T))||v->as(typeid(rpt))||v->as(typeid(rcptr))||var.isNull()) return true;
+        overload_cache::by_value()=true;
+        Svar ret=caster<T>::from(var);
+        if(!ret.is<T>()) return false;
+        scratch.replace(i,std::move(ret));
+        return true;
     }
 };
 
+}
+
+template <typename T>
+bool Svar::tryCast(T& out)const{
+    static_assert(!std::is_reference<T>::value,"tryCast returns values or pointers");
+    SvarArgs args;
+    args.push_back(*this);
+    detail::arg_scratch scratch(args);
+    if(!detail::arg_caster<T>::convert(args,0,scratch)) return false;
+    out=args[0].castAs<T>();
+    return true;
+}
+
 inline std::istream& operator >>(std::istream& ist,Svar& self)
 {
     Svar json=Svar::instance()["__builtin__"]["Json"];
@@ -4119,6 +6632,181 @@ inline int Svar::dtos(double value,char* buf)
     return dtoa_impl::format_buffer(first, len, decimal_exponent, kMinExp, kMaxExp)-buf;
 }
 
+namespace detail {
+
+/// Vectorized scans for Json, 32 byte blocks with AVX2 or 16 byte blocks with SSE2,
+/// the level is detected at runtime and the last partial block is scanned byte by byte
+namespace json_scan {
+
+enum Level{SCALAR=0,SSE2=1,AVX2=2};
+
+inline int detect(){
+#if defined(SVAR_SCAN_AVX2)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return AVX2;
+#endif
+#if defined(SVAR_SCAN_SSE2)
+    return SSE2;
+#else
+    return SCALAR;
+#endif
+}
+
+/// The level used by parsers created afterwards, lower it to compare against the scalar scan
+inline int& level(){
+    static int l=detect();
+    return l;
+}
+
+inline int first_bit(uint32_t mask){
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index,mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/// The closing quote or the next escape of a string
+struct string_stop{
+    static bool scalar(char c){return c=='"'||c=='\\';}
+#if defined(SVAR_SCAN_SSE2)
+    static uint32_t sse2(__m128i v){
+        return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8('"')),
+                                              _mm_cmpeq_epi8(v,_mm_set1_epi8('\\'))));
+    }
+#endif
+#if defined(SVAR_SCAN_AVX2)
+    __attribute__((target("avx2"))) static uint32_t avx2(__m256i v){
+        return _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v,_mm256_set1_epi8('"')),
+                                                    _mm256_cmpeq_epi8(v,_mm256_set1_epi8('\\'))));
+    }
+#endif
+};
+
+/// The first character that is not whitespace
+struct space_stop{
+    static bool scalar(char c){return c!=' '&&c!='\n'&&c!='\r'&&c!='\t';}
+#if defined(SVAR_SCAN_SSE2)
+    static uint32_t sse2(__m128i v){
+        __m128i space=_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8(' ')),
+                                                _mm_cmpeq_epi8(v,_mm_set1_epi8('\n'))),
+                                   _mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8('\r')),
+                                                _mm_cmpeq_epi8(v,_mm_set1_epi8('\t'))));
+        return ~_mm_movemask_epi8(space)&0xFFFF;
+    }
+#endif
+#if defined(SVAR_SCAN_AVX2)
+    __attribute__((target("avx2"))) static uint32_t avx2(__m256i v){
+        __m256i space=_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v,_mm256_set1_epi8(' ')),
+                                                      _mm256_cmpeq_epi8(v,_mm256_set1_epi8('\n'))),
+                                      _mm256_or_si256(_mm256_cmpeq_epi8(v,_mm256_set1_epi8('\r')),
+                                                      _mm256_cmpeq_epi8(v,_mm256_set1_epi8('\t'))));
+        return ~(uint32_t)_mm256_movemask_epi8(space);
+    }
+#endif
+};
+
+/// The first character that can not be part of a number
+struct number_stop{
+    static bool scalar(char c){
+        return !((c>='0'&&c<='9')||c=='.'||c=='e'||c=='E'||c=='+'||c=='-');
+    }
+#if defined(SVAR_SCAN_SSE2)
+    static uint32_t sse2(__m128i v){
+        __m128i d=_mm_sub_epi8(v,_mm_set1_epi8('0'));
+        __m128i digit=_mm_cmpeq_epi8(_mm_min_epu8(d,_mm_set1_epi8(9)),d);
+        __m128i exp=_mm_cmpeq_epi8(_mm_or_si128(v,_mm_set1_epi8(0x20)),_mm_set1_epi8('e'));
+        __m128i sign=_mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8('+')),_mm_cmpeq_epi8(v,_mm_set1_epi8('-')));
+        __m128i dot=_mm_cmpeq_epi8(v,_mm_set1_epi8('.'));
+        return ~_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit,exp),_mm_or_si128(sign,dot)))&0xFFFF;
+    }
+#endif
+#if defined(SVAR_SCAN_AVX2)
+    __attribute__((target("avx2"))) static uint32_t avx2(__m256i v){
+        __m256i d=_mm256_sub_epi8(v,_mm256_set1_epi8('0'));
+        __m256i digit=_mm256_cmpeq_epi8(_mm256_min_epu8(d,_mm256_set1_epi8(9)),d);
+        __m256i exp=_mm256_cmpeq_epi8(_mm256_or_si256(v,_mm256_set1_epi8(0x20)),_mm256_set1_epi8('e'));
+        __m256i sign=_mm256_or_si256(_mm256_cmpeq_epi8(v,_mm256_set1_epi8('+')),
+                                     _mm256_cmpeq_epi8(v,_mm256_set1_epi8('-')));
+        __m256i dot=_mm256_cmpeq_epi8(v,_mm256_set1_epi8('.'));
+        return ~(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(digit,exp),
+                                                               _mm256_or_si256(sign,dot)));
+    }
+#endif
+};
+
+/// Quotes and brackets, used to skip whole values
+struct skip_stop{
+    static bool scalar(char c){return c=='"'||c=='{'||c=='}'||c=='['||c==']';}
+#if defined(SVAR_SCAN_SSE2)
+    static uint32_t sse2(__m128i v){
+        // '[' ']' and '{' '}' only differ in the 0x20 bit
+        __m128i lower=_mm_or_si128(v,_mm_set1_epi8(0x20));
+        return _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v,_mm_set1_epi8('"')),
+                                              _mm_or_si128(_mm_cmpeq_epi8(lower,_mm_set1_epi8('{')),
+                                                           _mm_cmpeq_epi8(lower,_mm_set1_epi8('}')))));
+    }
+#endif
+#if defined(SVAR_SCAN_AVX2)
+    __attribute__((target("avx2"))) static uint32_t avx2(__m256i v){
+        __m256i lower=_mm256_or_si256(v,_mm256_set1_epi8(0x20));
+        return _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v,_mm256_set1_epi8('"')),
+                                                    _mm256_or_si256(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('{')),
+                                                                    _mm256_cmpeq_epi8(lower,_mm256_set1_epi8('}')))));
+    }
+#endif
+};
+
+template <typename Stop>
+inline const char* find_scalar(const char* p,const char* end){
+    while(p<end&&!Stop::scalar(*p)) ++p;
+    return p;
+}
+
+#if defined(SVAR_SCAN_SSE2)
+template <typename Stop>
+inline const char* find_sse2(const char* p,const char* end){
+    for(;end-p>=16;p+=16){
+        uint32_t mask=Stop::sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if(mask) return p+first_bit(mask);
+    }
+    return find_scalar<Stop>(p,end);
+}
+#endif
+
+#if defined(SVAR_SCAN_AVX2)
+template <typename Stop>
+__attribute__((target("avx2"))) inline const char* find_avx2(const char* p,const char* end){
+    for(;end-p>=32;p+=32){
+        uint32_t mask=Stop::avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+        if(mask) return p+first_bit(mask);
+    }
+    return find_scalar<Stop>(p,end);
+}
+#endif
+
+/// Return the first position in [p,end) where Stop matches, or end
+template <typename Stop>
+inline const char* find(const char* p,const char* end,int level){
+    // most runs are short, so check a few characters before loading blocks
+    for(const char* head=p+8;p<end&&p<head;++p)
+        if(Stop::scalar(*p)) return p;
+#if defined(SVAR_SCAN_AVX2)
+    if(level>=AVX2) return find_avx2<Stop>(p,end);
+#endif
+#if defined(SVAR_SCAN_SSE2)
+    if(level>=SSE2) return find_sse2<Stop>(p,end);
+#endif
+    (void)level;
+    return find_scalar<Stop>(p,end);
+}
+
+}
+
+}
+
 /// Json save and load class
 class Json final {
 public:
@@ -4126,51 +6814,382 @@ public:
         STANDARD, COMMENTS
     };
 
+    /// Receives the events of Json::parse in document order, every callback returns an Action.
+    /// SKIP from startObject, startArray or key skips that value without reporting it,
+    /// STOP ends the parse. Strings and keys are only valid during the callback.
+    class Handler{
+    public:
+        enum Action{STOP, CONTINUE, SKIP};
+
+        virtual ~Handler(){}
+        virtual Action startObject(){return CONTINUE;}
+        virtual Action key(const std::string&){return CONTINUE;}
+        virtual Action endObject(){return CONTINUE;}
+        virtual Action startArray(){return CONTINUE;}
+        virtual Action endArray(){return CONTINUE;}
+        virtual Action string(const std::string&){return CONTINUE;}
+        virtual Action integer(int64_t){return CONTINUE;}
+        virtual Action number(double){return CONTINUE;}
+        virtual Action boolean(bool){return CONTINUE;}
+        virtual Action null(){return CONTINUE;}
+    };
+
     static Svar load(const std::string& in){
-        Json parser(in,STANDARD);
-        Svar result = parser.parse_json(0);
+        return load(in.data(),in.size());
+    }
+
+    /// Parse size bytes at data in place, the input needs no trailing zero and is not copied
+    static Svar load(const char* data,size_t size){
+        Json parser(data,size,STANDARD);
+        tree_builder builder;
+        parser.parse_value(builder,0);
         // Check for any trailing garbage
         parser.consume_garbage();
         if (parser.failed){
             return Svar();
         }
-        if (parser.i != in.size())
-            return parser.fail("unexpected trailing " + esc(in[parser.i]));
+        if (parser.i != size)
+            return parser.fail("unexpected trailing " + esc(parser.str[parser.i]));
 
-        return result;
+        return builder.result();
+    }
+
+    static Svar load(const SvarBuffer& buffer){
+        return load(buffer.ptr<const char>(),buffer.size());
+    }
+
+    static Svar loadFile(const std::string& file_path){
+        return load(SvarBuffer::load(file_path));
+    }
+
+    /// Report the document to handler without building any value, memory use only depends
+    /// on the nesting depth and the longest string. Returns false if the handler stopped.
+    static bool parse(const char* data,size_t size,Handler& handler){
+        Json parser(data,size,STANDARD);
+        if (!parser.parse_value(handler,0))
+            return false;
+        parser.consume_garbage();
+        if (parser.i != size)
+            parser.fail("unexpected trailing " + esc(parser.str[parser.i]));
+        return true;
+    }
+
+    static bool parse(const std::string& in,Handler& handler){
+        return parse(in.data(),in.size(),handler);
+    }
+
+    /// Load newline delimited json (JSON Lines, NDJSON) into an array with one value per
+    /// non-empty line. The input is split at newlines and parsed on threads, 0 uses all cores.
+    static Svar loadLines(const char* data,size_t size,int threads=0){
+        std::vector<Svar> values;
+        loadLines(data,size,[&values](const Svar& batch){
+            const std::vector<Svar>& lines=batch.as<SvarArray>()._var;
+            values.insert(values.end(),lines.begin(),lines.end());
+        },threads);
+        return Svar(std::move(values));
+    }
+
+    static Svar loadLines(const SvarBuffer& buffer,int threads=0){
+        return loadLines(buffer.ptr<const char>(),buffer.size(),threads);
+    }
+
+    /// Pass newline delimited json to callback in batches, arrays with the values of about
+    /// batch_bytes of input. Batches arrive in input order when ordered, otherwise as soon as
+    /// they are parsed. The callback is never called concurrently, and at most two batches per
+    /// thread are held waiting for an earlier one. After an error no more batches are passed
+    /// and the exception is rethrown.
+    static void loadLines(const char* data,size_t size,const std::function<void(const Svar&)>& callback,
+                          int threads=0,bool ordered=true,size_t batch_bytes=1<<18){
+        // batches end after a newline or at the end of input
+        std::vector<size_t> bounds(1,0);
+        batch_bytes = std::max<size_t>(batch_bytes,1);
+        while (bounds.back() < size) {
+            size_t pos = bounds.back() + std::min(batch_bytes, size - bounds.back());
+            const char* newline = static_cast<const char*>(memchr(data + pos - 1, '\n', size - pos + 1));
+            bounds.push_back(newline ? newline - data + 1 : size);
+        }
+
+        size_t batches = bounds.size() - 1;
+        if (threads <= 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t workers = std::max<size_t>(1, std::min<size_t>(threads, batches));
+        size_t window = 2 * workers;
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::atomic<size_t> next(0);
+        size_t delivered = 0;          // batches passed to callback in order
+        std::map<size_t,Svar> ready;   // parsed batches waiting for an earlier one
+        std::exception_ptr error;      // the first exception, stops all workers
+
+        auto run = [&](){
+            while (true) {
+                size_t b = next++;
+                if (b >= batches)
+                    return;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (ordered)
+                        cond.wait(lock, [&](){return error || b < delivered + window;});
+                    if (error)
+                        return;
+                }
+
+                Svar batch;
+                try {
+                    batch = parse_lines(data, bounds[b], bounds[b+1]);
+                }
+                catch (...) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    cond.notify_all();
+                    return;
+                }
+
+                std::unique_lock<std::mutex> lock(mutex);
+                if (error)
+                    return;
+                try {
+                    if (!ordered) {
+                        callback(batch);
+                        continue;
+                    }
+                    // whoever completes the next batch delivers all consecutive ones
+                    ready[b] = batch;
+                    for (auto it = ready.begin(); it != ready.end() && it->first == delivered; it = ready.erase(it)) {
+                        callback(it->second);
+                        delivered++;
+                    }
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+                cond.notify_all();
+            }
+        };
+
+        detail::worker_pool::parallel_for(workers, [&](size_t){run();});
+        if (error)
+            std::rethrow_exception(error);
     }
 
+    /// Push parser for input that arrives in chunks, such as pipes or message fragments.
+    /// Chunks may split the input anywhere. Every completed top-level value is loaded and
+    /// passed to the callback. Only the partial value at the end of a chunk is buffered,
+    /// values that lie within one chunk are parsed in place.
+    class Stream{
+    public:
+        typedef std::function<void(const Svar&)> Callback;
+
+        Stream(Callback callback)
+            : _callback(std::move(callback)),_in_string(false),_escape(false),_in_scalar(false),
+              _scan(detail::json_scan::level()){}
+
+        void push(const std::string& chunk){
+            push(chunk.data(),chunk.size());
+        }
+
+        void push(const char* data,size_t size){
+            const char* end = data + size;
+            const char* p = data;
+            const char* start = busy() ? data : nullptr; // the value in progress
+            while (p < end) {
+                if (_in_string) {
+                    if (_escape) {
+                        _escape = false;
+                        ++p;
+                        continue;
+                    }
+                    p = detail::json_scan::find<detail::json_scan::string_stop>(p, end, _scan);
+                    if (p == end)
+                        break;
+                    if (*p++ == '\\') {
+                        _escape = true;
+                        continue;
+                    }
+                    _in_string = false;
+                    if (_nesting.empty())
+                        complete(start, p);
+                }
+                else if (!_nesting.empty()) {
+                    p = detail::json_scan::find<detail::json_scan::skip_stop>(p, end, _scan);
+                    if (p == end)
+                        break;
+                    char ch = *p++;
+                    if (ch == '"')
+                        _in_string = true;
+                    else if (ch == '{')
+                        _nesting.push_back('}');
+                    else if (ch == '[')
+                        _nesting.push_back(']');
+                    else if (ch != _nesting.back())
+                        fail("unexpected " + std::string(1, ch) + " in stream");
+                    else {
+                        _nesting.pop_back();
+                        if (_nesting.empty())
+                            complete(start, p);
+                    }
+                }
+                else if (_in_scalar) {
+                    // numbers and literals end at the next delimiter, which is not consumed
+                    while (p < end && !delimiter(*p))
+                        ++p;
+                    if (p == end)
+                        break;
+                    _in_scalar = false;
+                    complete(start, p);
+                }
+                else {
+                    p = detail::json_scan::find<detail::json_scan::space_stop>(p, end, _scan);
+                    if (p == end)
+                        break;
+                    start = p;
+                    char ch = *p++;
+                    if (ch == '{')
+                        _nesting.push_back('}');
+                    else if (ch == '[')
+                        _nesting.push_back(']');
+                    else if (ch == '"')
+                        _in_string = true;
+                    else if (delimiter(ch))
+                        fail("unexpected " + std::string(1, ch) + " in stream");
+                    else
+                        _in_scalar = true;
+                }
+            }
+
+            if (busy())
+                _pending.append(start, end - start);
+        }
+
+        /// End of input, loads a trailing top-level number or literal and
+        /// throws if a value is still incomplete.
+        void finish(){
+            if (_in_scalar) {
+                _in_scalar = false;
+                complete(_pending.data(), _pending.data());
+            }
+            if (busy())
+                fail("unexpected end of input in stream");
+        }
+
+        /// Bytes held for the value in progress.
+        size_t pending() const {return _pending.size();}
+
+    private:
+        bool busy() const {return _in_string || _in_scalar || !_nesting.empty();}
+
+        static bool delimiter(char ch){
+            switch (ch) {
+            case ' ': case '\t': case '\r': case '\n':
+            case '{': case '}': case '[': case ']': case '"': case ',': case ':':
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /// The value ends at end of the current chunk and started at start or in _pending.
+        void complete(const char* start, const char* end){
+            if (_pending.empty()) {
+                _callback(Json::load(start, end - start));
+                return;
+            }
+            std::string text;
+            text.swap(_pending);
+            text.append(start, end - start);
+            _callback(Json::load(text));
+        }
+
+        void fail(std::string&& msg){
+            _pending.clear();
+            _nesting.clear();
+            _in_string = _escape = _in_scalar = false;
+            throw SvarExeption(msg);
+        }
+
+        Callback    _callback;
+        std::string _pending;   ///< the start of the value in progress from earlier chunks
+        std::string _nesting;   ///< expected closing brackets of the value in progress
+        bool        _in_string, _escape, _in_scalar;
+        const int   _scan;
+    };
+
 private:
-    Json(const std::string& str_input, JsonParse parse_strategy=STANDARD)
-        :str(str_input),i(0),failed(false),strategy(parse_strategy){
-        for(int i=0;i<128;i++) {invalidmask[i]=0;namemask[i]=0;}
+    /// Non-owning view of the input, reading past the end gives 0 as std::string does
+    struct Input{
+        const char* data;
+        size_t      length;
+
+        char operator[](size_t pos) const {return pos<length?data[pos]:0;}
+        size_t size() const {return length;}
+        std::string substr(size_t pos,size_t n) const {
+            pos=std::min(pos,length);
+            return std::string(data+pos,std::min(n,length-pos));
+        }
+    };
+
+    Json(const char* data, size_t size, JsonParse parse_strategy=STANDARD)
+        :str{data,size},i(0),failed(false),strategy(parse_strategy),scan(detail::json_scan::level()){
+        for(int i=0;i<256;i++) {invalidmask[i]=0;namemask[i]=0;}
         for(unsigned char c='0';c<='9';c++) namemask[c]=1;
         for(unsigned char c='A';c<='Z';c++) namemask[c]=2;
         for(unsigned char c='a';c<'z';c++) namemask[c]=2;
         namemask['_']=2;
     }
 
-    std::string str;
+    /// The values of the non-empty lines in [begin,end).
+    static Svar parse_lines(const char* data, size_t begin, size_t end) {
+        std::vector<Svar> values;
+        for (size_t pos = begin; pos < end;) {
+            const char* newline = static_cast<const char*>(memchr(data + pos, '\n', end - pos));
+            size_t stop = newline ? newline - data : end;
+            size_t first = pos;
+            while (first < stop && (data[first] == ' ' || data[first] == '\t' || data[first] == '\r'))
+                first++;
+            if (first < stop) {
+                try {
+                    values.push_back(load(data + first, stop - first));
+                }
+                catch (SvarExeption& e) {
+                    throw SvarExeption("line at byte " + std::to_string(pos) + ": " + e.what());
+                }
+            }
+            pos = stop + 1;
+        }
+        return Svar(std::move(values));
+    }
+
+    Input  str;
     size_t i;
     std::string err;
     bool failed;
     const JsonParse strategy;
+    const int scan;
     const int max_depth = 200;
-    int   invalidmask[128],namemask[128];
+    int   invalidmask[256],namemask[256];
+    std::string text; ///< strings and keys reported to a Handler, reused between events
 
     /// fail(msg, err_ret = Json())
     Svar fail(std::string &&msg) {
         if (!failed)
             err = std::move(msg);
         failed = true;
-        throw SvarExeption(msg);
+        throw SvarExeption(err);
         return Svar();
     }
 
     /// Advance until the current character is non-whitespace.
     void consume_whitespace() {
-        while (str[i] == ' ' || str[i] == '\r' || str[i] == '\n' || str[i] == '\t')
-            i++;
+        i = find<detail::json_scan::space_stop>(i);
+    }
+
+    /// Return the first position from pos where Stop matches, or the end of input.
+    template <typename Stop>
+    size_t find(size_t pos) const {
+        if (pos >= str.size()) return pos;
+        return detail::json_scan::find<Stop>(str.data + pos, str.data + str.size(), scan) - str.data;
     }
 
     /// Advance comments (c-style inline and multiline).
@@ -4319,57 +7338,59 @@ private:
         }
     }
 
-    /// Parse a string, starting at the current position.
-    std::string parse_string() {
-        std::string out;
+    /// Parse a string, starting at the current position, and append it to out.
+    void parse_string(std::string& out) {
         long last_escaped_codepoint = -1;
         while (true) {
+            // Runs without escapes are copied at once
+            size_t start = i;
+            i = find<detail::json_scan::string_stop>(i);
+            if (i > start) {
+                if (last_escaped_codepoint >= 0) {
+                    encode_utf8(last_escaped_codepoint, out);
+                    last_escaped_codepoint = -1;
+                }
+                out.append(str.data + start, i - start);
+            }
+
             if (i == str.size())
                 fail("unexpected end of input in string");
 
-            char ch = str[i++];
-
-            switch (ch) {
-            case '"':
+            if (str.data[i++] == '"') {
                 encode_utf8(last_escaped_codepoint, out);
-                return out;
-            case '\\':
-                handle_escape(last_escaped_codepoint,out);
-                break;
-            default:
-                if(last_escaped_codepoint>=0){
-                    encode_utf8(last_escaped_codepoint, out);
-                    last_escaped_codepoint = -1;
-                }
-                out += ch;
-                break;
+                return;
             }
+            handle_escape(last_escaped_codepoint,out);
         }
     }
 
-    /// Parse a double.
-    Svar parse_number() {
+    /// Parse a number, integers are returned in integer and everything else in d.
+    bool scan_number(int64_t& integer, double& d) {
         size_t start_pos = i;
 
         if (str[i] == '-')
             i++;
 
-        // Integer part
+        // Integer part, accumulated while scanning so that integers need no second pass
+        uint64_t value = 0;
         if (str[i] == '0') {
             i++;
             if (in_range(str[i], '0', '9'))
-                return fail("leading 0s not permitted in numbers");
+                fail("leading 0s not permitted in numbers");
         } else if (in_range(str[i], '1', '9')) {
-            i++;
             while (in_range(str[i], '0', '9'))
-                i++;
+                value = value * 10 + (str[i++] - '0');
         } else {
-            return fail("invalid " + esc(str[i]) + " in number");
+            fail("invalid " + esc(str[i]) + " in number");
         }
 
+        bool negative = str[start_pos] == '-';
+        size_t digits = i - start_pos - negative;
         if (str[i] != '.' && str[i] != 'e' && str[i] != 'E'
-                && (i - start_pos) <= static_cast<size_t>(std::numeric_limits<int>::digits10)) {
-            return std::atoi(str.c_str() + start_pos);
+                && digits <= static_cast<size_t>(std::numeric_limits<uint64_t>::digits10)
+                && value <= (uint64_t)std::numeric_limits<int64_t>::max() + negative) {
+            integer = negative ? (int64_t)(0 - value) : (int64_t)value;
+            return true;
         }
 
 //        // Decimal part
@@ -4396,9 +7417,23 @@ private:
 //                i++;
 //        }
 
-        double d;
-        i=fast_double_parser::parse_number(str.c_str()+start_pos,&d)-str.c_str();
-        return d;
+        // The input may end right after the number, parse a terminated copy then
+        size_t end = find<detail::json_scan::number_stop>(i);
+
+        if (end < str.size()){
+            const char* stop = fast_double_parser::parse_number(str.data + start_pos, &d);
+            if (!stop)
+                fail("invalid number " + str.substr(start_pos, end - start_pos));
+            i = stop - str.data;
+        }
+        else{
+            std::string tail(str.data + start_pos, end - start_pos);
+            const char* stop = fast_double_parser::parse_number(tail.c_str(), &d);
+            if (!stop)
+                fail("invalid number " + tail);
+            i = start_pos + (stop - tail.c_str());
+        }
+        return false;
 //        return std::strtod(str.c_str() + start_pos, nullptr);
     }
 
@@ -4414,7 +7449,8 @@ private:
     Svar expect(const std::string &expected, const Svar& res) {
         assert(i != 0);
         i--;
-        if (str.compare(i, expected.length(), expected) == 0) {
+        if (i + expected.length() <= str.size()
+                && expected.compare(0, expected.length(), str.data + i, expected.length()) == 0) {
             i += expected.length();
             return res;
         } else if (namemask[static_cast<unsigned char>(str[i++])]>=2){
@@ -4425,84 +7461,240 @@ private:
         }
     }
 
-    /// Parse a JSON object.
-    Svar parse_json(int depth) {
-        if (depth > max_depth) {
-            return fail("exceeded maximum nesting depth");
+    /// Handler of load, the values of the containers still open are kept on one stack
+    /// and moved into their container when it ends.
+    class tree_builder{
+    public:
+        Handler::Action startObject(){
+            _open.push_back(std::make_pair(_items.size(), _keys.size()));
+            return Handler::CONTINUE;
+        }
+        Handler::Action key(const std::string& k){
+            _keys.push_back(SvarKey(k));
+            return Handler::CONTINUE;
+        }
+        Handler::Action endObject(){
+            size_t first = _open.back().first, keys = _open.back().second;
+            _open.pop_back();
+            SvarObject::map_type data;
+            for (size_t n = first; n < _items.size(); n++)
+                data.insert(std::make_pair(_keys[keys + n - first], std::move(_items[n])));
+            while (_items.size() > first)
+                _items.pop_back();
+            while (_keys.size() > keys)
+                _keys.pop_back();
+            return value((std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::move(data)));
+        }
+        Handler::Action startArray(){
+            _open.push_back(std::make_pair(_items.size(), _keys.size()));
+            return Handler::CONTINUE;
+        }
+        Handler::Action endArray(){
+            size_t first = _open.back().first;
+            _open.pop_back();
+            std::vector<Svar> data(std::make_move_iterator(_items.begin() + first),
+                                   std::make_move_iterator(_items.end()));
+            while (_items.size() > first)
+                _items.pop_back();
+            return value(std::move(data));
+        }
+        Handler::Action string(std::string& s){return value(std::move(s));}
+        Handler::Action string(const std::string& s){return value(s);}
+        Handler::Action integer(int64_t v){
+            if (v >= std::numeric_limits<int>::min() && v <= std::numeric_limits<int>::max())
+                return value((int)v);
+            return value(v);
+        }
+        Handler::Action number(double d){return value(d);}
+        Handler::Action boolean(bool b){return value(b);}
+        Handler::Action null(){return value(Svar(Svar::Null()));}
+
+        Handler::Action value(Svar&& v){
+            if (_open.empty())
+                _result = std::move(v);
+            else
+                _items.push_back(std::move(v));
+            return Handler::CONTINUE;
+        }
+
+        const Svar& result() const {return _result;}
+
+    private:
+        // small documents are built without allocating the stacks
+        detail::small_vector<Svar,16>                       _items;
+        detail::small_vector<SvarKey,16>                    _keys;
+        detail::small_vector<std::pair<size_t,size_t>,16>   _open;  ///< first item and key of each open container
+        Svar                                                _result;
+    };
+
+    bool report(Handler::Action action) {
+        return action != Handler::STOP;
+    }
+
+    /// Report true, false, null or a name returned by expect.
+    template <typename H>
+    bool report_literal(H& handler, const Svar& value) {
+        if (value.is<bool>())
+            return report(handler.boolean(value.as<bool>()));
+        if (value.isNull())
+            return report(handler.null());
+        return report(handler.string(value.as<std::string>()));
+    }
+
+    /// Placeholders such as <SvarFunction> are loaded as undefined and reported as null.
+    bool report_placeholder(Handler& handler) {
+        return report(handler.null());
+    }
+
+    bool report_placeholder(tree_builder& builder) {
+        return report(builder.value(Svar()));
+    }
+
+    /// Skip a string, starting after the opening quote.
+    void skip_string() {
+        while (true) {
+            i = find<detail::json_scan::string_stop>(i);
+            if (i >= str.size())
+                fail("unexpected end of input in string");
+            if (str.data[i++] == '"')
+                return;
+            i++; // the escaped character
+        }
+    }
+
+    /// Skip an object or array, starting after its opening bracket. Only strings and
+    /// the nesting of the brackets are checked.
+    void skip_container(char opening) {
+        std::string nesting(1, opening == '{' ? '}' : ']');
+        while (true) {
+            i = find<detail::json_scan::skip_stop>(i);
+            if (i >= str.size())
+                fail("unexpected end of input");
+            char ch = str.data[i++];
+            if (ch == '"')
+                skip_string();
+            else if (ch == '{')
+                nesting.push_back('}');
+            else if (ch == '[')
+                nesting.push_back(']');
+            else if (ch != nesting.back())
+                fail("expected " + std::string(1, nesting.back()) + ", got " + esc(ch));
+            else {
+                nesting.pop_back();
+                if (nesting.empty())
+                    return;
+            }
+        }
+    }
+
+    /// Skip the next value.
+    void skip_value() {
+        char ch = get_next_token();
+        if (ch == '{' || ch == '[')
+            return skip_container(ch);
+        if (ch == '"')
+            return skip_string();
+        // numbers, literals and names end at the next delimiter
+        while (i < str.size()) {
+            ch = str.data[i];
+            if (ch == ',' || ch == '}' || ch == ']' || ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t')
+                break;
+            i++;
         }
+    }
+
+    /// Parse a value and report it to handler, return false once the handler stops.
+    /// load passes a tree_builder, parse a Handler.
+    template <typename H>
+    bool parse_value(H& handler, int depth) {
+        if (depth > max_depth)
+            fail("exceeded maximum nesting depth");
 
         unsigned char ch = get_next_token();
-        if (failed)
-            return Svar();
 
         switch (ch) {
         case 't':
-            return expect("true", true);
+            return report_literal(handler, expect("true", true));
         case 'f':
-            return expect("false", false);
+            return report_literal(handler, expect("false", false));
         case 'n':
-            return expect("null", Svar::Null());
+            return report_literal(handler, expect("null", Svar::Null()));
         case '"':
-            return parse_string();
+            text.clear();
+            parse_string(text);
+            return report(handler.string(text));
         case '{':{
-            std::unordered_map<std::string, Svar> data;
+            Handler::Action action = handler.startObject();
+            if (action == Handler::SKIP){
+                skip_container('{');
+                return true;
+            }
+            if (action == Handler::STOP)
+                return false;
+
             ch = get_next_token();
             if (ch == '}')
-                return data;
+                return report(handler.endObject());
 
             while (1) {
-                std::string key;
+                text.clear();
                 if (ch == '"')
-                    key = parse_string();
-                else if (namemask[ch]>=2){
-                    key = parse_name();
-                }
+                    parse_string(text);
+                else if (namemask[ch]>=2)
+                    text = parse_name();
                 else
-                    return fail("expected '\"' in object, got " + esc(ch));
-
-                if (failed)
-                    return Svar();
+                    fail("expected '\"' in object, got " + esc(ch));
 
                 ch = get_next_token();
                 if (ch != ':')
-                    return fail("expected ':' in object, got " + esc(ch));
+                    fail("expected ':' in object, got " + esc(ch));
 
-                data.insert(std::make_pair(std::move(key),parse_json(depth + 1)));
-                if (failed)
-                    return Svar();
+                action = handler.key(text);
+                if (action == Handler::STOP)
+                    return false;
+                if (action == Handler::SKIP)
+                    skip_value();
+                else if (!parse_value(handler, depth + 1))
+                    return false;
 
                 ch = get_next_token();
                 if (ch == '}')
                     break;
                 if (ch != ',')
-                    return fail("expected ',' in object, got " + esc(ch));
+                    fail("expected ',' in object, got " + esc(ch));
 
                 ch = get_next_token();
             }
-            return data;
+            return report(handler.endObject());
         }
         case '[':{
-            std::vector<Svar> data;
+            Handler::Action action = handler.startArray();
+            if (action == Handler::SKIP){
+                skip_container('[');
+                return true;
+            }
+            if (action == Handler::STOP)
+                return false;
+
             ch = get_next_token();
             if (ch == ']')
-                return data;
+                return report(handler.endArray());
 
             while (1) {
                 i--;
-                data.push_back(parse_json(depth + 1));
-                if (failed)
-                    return Svar();
+                if (!parse_value(handler, depth + 1))
+                    return false;
 
                 ch = get_next_token();
                 if (ch == ']')
                     break;
                 if (ch != ',')
-                    return fail("expected ',' in list, got " + esc(ch));
+                    fail("expected ',' in list, got " + esc(ch));
 
                 ch = get_next_token();
                 (void)ch;
             }
-            return data;
+            return report(handler.endArray());
         }
         case '<':{
             while (1) {
@@ -4510,21 +7702,27 @@ private:
                 if (ch == '>')
                     break;
             }
-            return Svar();
+            return report_placeholder(handler);
         }
         default:{
             if (ch == '-' || (ch >= '0' && ch <= '9')) {
                 i--;
-                return parse_number();
+                int64_t v;
+                double d;
+                if (scan_number(v, d))
+                    return report(handler.integer(v));
+                return report(handler.number(d));
             }
             if (namemask[ch]>=2){
-                return parse_name();
+                text = parse_name();
+                return report(handler.string(text));
             }
             break;
         }
         }
 
-        return fail("expected value, got " + esc(ch));
+        fail("expected value, got " + esc(ch));
+        return false;
     }
 };
 
@@ -4678,6 +7876,14 @@ public:
             return Svar();
         }
 
+        // values are shared with the plugin, so its header must have the same layout and type tags
+        int (*getVersion)()=plugin->hasSymbol("svarVersion")?(int (*)())plugin->getSymbol("svarVersion"):nullptr;
+        if(!getVersion||getVersion()!=SVAR_VERSION){
+            std::cerr<<pluginName<<" was built with another Svar version, expected "<<std::hex
+                     <<SVAR_VERSION<<std::dec<<". Please rebuild it."<<std::endl;
+            return Svar();
+        }
+
         sv::Svar* (*getInst)()=(sv::Svar* (*)())plugin->getSymbol("svarInstance");
         if(!getInst){
             std::cerr<<"No svarInstance found in "<<pluginName<<std::endl;
@@ -4896,47 +8102,88 @@ public:
 
         SvarClass::Class<int>()
                 .def("__init__",&SvarBuiltin::int_create)
+                .def("__int64_t__",[](int& i){return (int64_t)i;})
                 .def("__double__",[](int& i){return (double)i;})
                 .def("__bool__",[](int& i){return (bool)i;})
                 .def("__str__",[](int& i){return std::to_string(i);})
-                .def("__eq__",[](int& self,int rh){return self==rh;})
-                .def("__lt__",[](int& self,int rh){return self<rh;})
+                .def("__eq__",[](int& self,int64_t rh){return self==rh;})
+                .def("__lt__",[](int& self,int64_t rh){return self<rh;})
                 .def("__add__",[](int& self,Svar& rh)->Svar{
-            if(rh.is<int>()) return Svar(self+rh.as<int>());
+            if(rh.is<int>()) return detail::integer((int64_t)self+rh.as<int>());
+            if(rh.is<int64_t>()) return detail::integer64<detail::op_add>(self,rh.as<int64_t>());
             if(rh.is<double>()) return Svar(self+rh.as<double>());
             return Svar::Undefined();
         })
                 .def("__sub__",[](int self,Svar& rh)->Svar{
-            if(rh.is<int>()) return Svar(self-rh.as<int>());
+            if(rh.is<int>()) return detail::integer((int64_t)self-rh.as<int>());
+            if(rh.is<int64_t>()) return detail::integer64<detail::op_sub>(self,rh.as<int64_t>());
             if(rh.is<double>()) return Svar(self-rh.as<double>());
             return Svar::Undefined();
         })
                 .def("__mul__",[](int& self,Svar rh)->Svar{
-            if(rh.is<int>()) return Svar(self*rh.as<int>());
+            if(rh.is<int>()) return detail::integer((int64_t)self*rh.as<int>());
+            if(rh.is<int64_t>()) return detail::integer64<detail::op_mul>(self,rh.as<int64_t>());
             if(rh.is<double>()) return Svar(self*rh.as<double>());
             return Svar::Undefined();
         })
                 .def("__div__",[](int& self,Svar rh){
             if(rh.is<int>()) return Svar(self/rh.as<int>());
+            if(rh.is<int64_t>()) return detail::integer64<detail::op_div>(self,rh.as<int64_t>());
             if(rh.is<double>()) return Svar(self/rh.as<double>());
             return Svar::Undefined();
         })
                 .def("__mod__",[](int& self,int& rh){
             return self%rh;
         })
-                .def("__neg__",[](int& self){return -self;})
+                .def("__neg__",[](int& self){return detail::integer(-(int64_t)self);})
                 .def("__xor__",[](int& self,int& rh){return self^rh;})
                 .def("__or__",[](int& self,int& rh){return self|rh;})
                 .def("__and__",[](int& self,int& rh){return self&rh;});
 
+        SvarClass::Class<int64_t>()
+                .def("__init__",&SvarBuiltin::int64_create)
+                .def("__int__",[](int64_t& i){return (int)i;})
+                .def("__double__",[](int64_t& i){return (double)i;})
+                .def("__bool__",[](int64_t& i){return (bool)i;})
+                .def("__str__",[](int64_t& i){return std::to_string(i);})
+                .def("__eq__",[](int64_t& self,int64_t rh){return self==rh;})
+                .def("__lt__",[](int64_t& self,int64_t rh){return self<rh;})
+                .def("__add__",[](int64_t& self,Svar& rh)->Svar{
+            if(rh.is<int>()||rh.is<int64_t>()) return detail::integer64<detail::op_add>(self,rh.castAs<int64_t>());
+            if(rh.is<double>()) return Svar(self+rh.as<double>());
+            return Svar::Undefined();
+        })
+                .def("__sub__",[](int64_t& self,Svar& rh)->Svar{
+            if(rh.is<int>()||rh.is<int64_t>()) return detail::integer64<detail::op_sub>(self,rh.castAs<int64_t>());
+            if(rh.is<double>()) return Svar(self-rh.as<double>());
+            return Svar::Undefined();
+        })
+                .def("__mul__",[](int64_t& self,Svar& rh)->Svar{
+            if(rh.is<int>()||rh.is<int64_t>()) return detail::integer64<detail::op_mul>(self,rh.castAs<int64_t>());
+            if(rh.is<double>()) return Svar(self*rh.as<double>());
+            return Svar::Undefined();
+        })
+                .def("__div__",[](int64_t& self,Svar& rh)->Svar{
+            if(rh.is<int>()||rh.is<int64_t>()) return detail::integer64<detail::op_div>(self,rh.castAs<int64_t>());
+            if(rh.is<double>()) return Svar(self/rh.as<double>());
+            return Svar::Undefined();
+        })
+                .def("__mod__",[](int64_t& self,int64_t rh){return rh==-1?0:self%rh;})
+                .def("__neg__",[](int64_t& self){return detail::integer64<detail::op_sub>(0,self);})
+                .def("__xor__",[](int64_t& self,int64_t rh){return self^rh;})
+                .def("__or__",[](int64_t& self,int64_t rh){return self|rh;})
+                .def("__and__",[](int64_t& self,int64_t rh){return self&rh;});
+
         SvarClass::Class<bool>()
                 .def("__int__",[](bool& b){return (int)b;})
+                .def("__int64_t__",[](bool& b){return (int64_t)b;})
                 .def("__double__",[](bool& b){return (double)b;})
                 .def("__str__",[](bool& b){return std::to_string(b);})
                 .def("__eq__",[](bool& self,bool& rh){return self==rh;});
 
         SvarClass::Class<double>()
                 .def("__int__",[](double& d){return (int)d;})
+                .def("__int64_t__",[](double& d){return (int64_t)d;})
                 .def("__bool__",[](double& d){return (bool)d;})
                 .def("__str__",[](double& d){return std::to_string(d);})
                 .def("__eq__",[](double& self,double rh){return self==rh;})
@@ -4969,19 +8216,8 @@ public:
             std::unique_lock<std::mutex> lock(self._mutex);
             self._var.erase(self._var.begin()+idx);
         })
-        .def("__add__",[](const SvarArray& self,const SvarArray& other){
-            std::unique_lock<std::mutex> lock1(self._mutex);
-            std::unique_lock<std::mutex> lock2(other._mutex);
-            std::vector<Svar> ret(self._var);
-            ret.insert(ret.end(),other._var.begin(),other._var.end());
-            return ret;
-        })
-            .def("__mul__",[](const SvarArray& self,const int& num){
-            std::vector<Svar> ret;
-            for(int i=0;i<num;++i)
-                ret.insert(ret.end(),self._var.begin(),self._var.end());
-            return ret;
-        });
+        .def("__add__",&detail::array_add)
+        .def("__mul__",&detail::array_mul);
 
         SvarClass::Class<SvarDict>()
                 .def("__getitem__",&SvarDict::operator [])
@@ -4989,29 +8225,12 @@ public:
 
 
         SvarClass::Class<SvarObject>()
-                .def("__getitem__",&SvarObject::operator [])
+                .def("__getitem__",[](const SvarObject& self,const std::string& id){return self[id];})
                 .def("__delitem__",[](SvarObject& self,const std::string& id){
             std::unique_lock<std::mutex> lock(self._mutex);
-            self._var.erase(id);
+            self._var.erase(SvarKey(id));
         })
-                .def("__add__",[](const SvarObject& self,const SvarObject& rh){
-            if(&self==&rh)
-            {
-                std::unique_lock<std::mutex> lock1(self._mutex);
-                return self._var;
-            }
-            else
-            {
-                auto ret=self._var;
-                std::unique_lock<std::mutex> lock1(self._mutex);
-                std::unique_lock<std::mutex> lock2(rh._mutex);
-                for(auto it:rh._var){
-                    if(ret.find(it.first)==ret.end())
-                        ret.insert(it);
-                }
-                return ret;
-            }
-        });
+                .def("__add__",&detail::object_add);
 
         SvarClass::Class<SvarFunction>()
                 .def("__doc__",[](SvarFunction& self){
@@ -5024,7 +8243,9 @@ public:
                 .def("__getitem__",[](SvarClass& self,const std::string& i)->Svar{return self[i];});
 
         SvarClass::Class<Json>()
-                .def_static("load",&Json::load);
+                .def_static("load",(Svar(*)(const std::string&))&Json::load)
+                .def_static("load",(Svar(*)(const SvarBuffer&))&Json::load)
+                .def_static("loadFile",&Json::loadFile);
 
         SvarClass::Class<SvarBuffer>()
                 .def("size",&SvarBuffer::size)
@@ -5054,6 +8275,9 @@ public:
         builtin["tag"]=std::string(BUILD_VERSION);
 #endif
         builtin["import"]=&Registry::load;
+        builtin["memory"]=&SvarArena::stats;
+        builtin["profiling"]=&SvarFunction::setProfiling;
+        builtin["profile"]=&SvarFunction::profile;
     }
 
     static Svar int_create(const Svar& rh){
@@ -5065,6 +8289,16 @@ public:
         throw SvarExeption("Can't construct int from "+rh.typeName()+".");
         return Svar::Undefined();
     }
+
+    static Svar int64_create(const Svar& rh){
+        if(rh.is<int64_t>()) return rh;
+        if(rh.is<std::string>()) return (Svar)(int64_t)std::atoll(rh.as<std::string>().c_str());
+        int64_t ret;
+        if(detail::number_cast(rh.value().get(),ret)) return ret;
+
+        throw SvarExeption("Can't construct int64_t from "+rh.typeName()+".");
+        return Svar::Undefined();
+    }
 };
 
 static SvarBuiltin SvarBuiltinInitializerinstance;
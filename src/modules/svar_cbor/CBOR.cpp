@@ -103,14 +103,14 @@ public:
                 funcs[it]=[](u_char c,IStream& i){return Svar((int)c);};
             funcs[0x18]=[](u_char c,IStream& i){uint8_t v;i>>v;return Svar((int)v);};
             funcs[0x19]=[](u_char c,IStream& i){uint16_t v;i>>v;return Svar((int)v);};
-            funcs[0x1A]=[](u_char c,IStream& i){uint32_t v;i>>v;return Svar((int)v);};
-            funcs[0x1B]=[](u_char c,IStream& i){uint64_t v;i>>v;return Svar((int)v);};//positive int
+            funcs[0x1A]=[](u_char c,IStream& i){uint32_t v;i>>v;return positive(v);};
+            funcs[0x1B]=[](u_char c,IStream& i){uint64_t v;i>>v;return positive(v);};//positive int
             for(u_char it=0x20;it<=0x37;it++)
                 funcs[it]=[](u_char c,IStream& i){return Svar((int)(-1-(c-0x20)));};
             funcs[0x38]=[](u_char c,IStream& i){uint8_t v;i>>v;return Svar((int)(-1-v));};
             funcs[0x39]=[](u_char c,IStream& i){uint16_t v;i>>v;return Svar((int)(-1-v));};
-            funcs[0x3A]=[](u_char c,IStream& i){uint32_t v;i>>v;return Svar((int)(-1-v));};
-            funcs[0x3B]=[](u_char c,IStream& i){uint64_t v;i>>v;return Svar((int)(-1-v));};//negative int
+            funcs[0x3A]=[](u_char c,IStream& i){uint32_t v;i>>v;return negative(v);};
+            funcs[0x3B]=[](u_char c,IStream& i){uint64_t v;i>>v;return negative(v);};//negative int
             for(u_char it=0x40;it<=0x5F;it++)
                 funcs[it]=[](u_char c,IStream& i){
                     int len = funcs[c-0x40](c-0x40,i).as<int>();
@@ -135,15 +135,15 @@ public:
             for(u_char it=0xA0;it<=0xBB;it++)
                 funcs[it]=[](u_char c,IStream& i){
                     int len = funcs[c-0xA0](c-0xA0,i).as<int>();
-                    std::map<std::string,Svar> m;
+                    SvarObject::map_type m;
                     for(int j=0;j<len;j++){
                         uint8_t t1,t2;
                         i>>t1;
                         Svar f=funcs[t1](t1,i);
                         i>>t2;
-                        m[f.castAs<std::string>()]=funcs[t2](t2,i);
+                        m[SvarKey(f.castAs<std::string>())]=funcs[t2](t2,i);
                     }
-                    return Svar(m);
+                    return Svar((std::shared_ptr<SvarValue>)detail::make_node<SvarObject>(std::move(m)));
                 };//map
             funcs[0xF4]=[](u_char c,IStream& i){return Svar(false);};//false
             funcs[0xF5]=[](u_char c,IStream& i){return Svar(true);};//true
@@ -155,6 +155,19 @@ public:
         return funcs[c](c,i);
     }
 
+    // integers are loaded as int when they fit, then int64_t, and double beyond that
+    static Svar positive(uint64_t v){
+        if(v<=(uint64_t)std::numeric_limits<int>::max()) return (int)v;
+        if(v<=(uint64_t)std::numeric_limits<int64_t>::max()) return (int64_t)v;
+        return (double)v;
+    }
+
+    static Svar negative(uint64_t v){// the value is -1-v
+        if(v<=(uint64_t)std::numeric_limits<int>::max()) return (int)(-1-(int64_t)v);
+        if(v<=(uint64_t)std::numeric_limits<int64_t>::max()) return (int64_t)(-1-(int64_t)v);
+        return -1.-(double)v;
+    }
+
     static SvarBuffer dump(Svar var){
         OSize sz;
         dumpStream(sz,var);
@@ -167,6 +180,60 @@ public:
 
     static char c(std::uint8_t x){return *reinterpret_cast<char*>(&x);}
 
+    template <typename T>
+    static T& dumpInteger(T& o,int64_t v)
+    {
+        if (v >= 0)
+        {
+            if (v <= 0x17)
+            {
+                return o<<c(static_cast<std::uint8_t>(v));
+            }
+            else if (v <= (std::numeric_limits<std::uint8_t>::max)())
+            {
+                return o<<c(0x18)<<c(static_cast<std::uint8_t>(v));
+            }
+            else if (v <= (std::numeric_limits<std::uint16_t>::max)())
+            {
+                return o<<c(0x19)<<(static_cast<std::uint16_t>(v));
+            }
+            else if (v <= (std::numeric_limits<std::uint32_t>::max)())
+            {
+                return o<<c(0x1A)<<static_cast<std::uint32_t>(v);
+            }
+            else
+            {
+                return o<<c(0x1B)<<static_cast<std::uint64_t>(v);
+            }
+        }
+        else
+        {
+            // The conversions below encode the sign in the first
+            // byte, and the value is converted to a positive number.
+            const auto n = -1 - v;
+            if (v >= -24)
+            {
+                return o<<static_cast<std::uint8_t>(0x20 + n);
+            }
+            else if (n <= (std::numeric_limits<std::uint8_t>::max)())
+            {
+                return o<<c(0x38)<<static_cast<std::uint8_t>(n);
+            }
+            else if (n <= (std::numeric_limits<std::uint16_t>::max)())
+            {
+                return o<<c(0x39)<<static_cast<std::uint16_t>(n);
+            }
+            else if (n <= (std::numeric_limits<std::uint32_t>::max)())
+            {
+                return o<<c(0x3A)<<static_cast<std::uint32_t>(n);
+            }
+            else
+            {
+                return o<<c(0x3B)<<static_cast<std::uint64_t>(n);
+            }
+        }
+    }
+
     template <typename T>
     static T& dumpStream(T& o,Svar var)
     {
@@ -180,58 +247,10 @@ public:
             return o<<c(0xFB)<<var.as<double>();
 
         if(var.is<int>())
-        {
-            const int& v=var.as<int>();
-            if (v >= 0)
-            {
-                if (v <= 0x17)
-                {
-                    return o<<c(static_cast<std::uint8_t>(v));
-                }
-                else if (v <= (std::numeric_limits<std::uint8_t>::max)())
-                {
-                    return o<<c(0x18)<<c(static_cast<std::uint8_t>(v));
-                }
-                else if (v <= (std::numeric_limits<std::uint16_t>::max)())
-                {
-                    return o<<c(0x19)<<(static_cast<std::uint16_t>(v));
-                }
-                else if (v <= (std::numeric_limits<std::uint32_t>::max)())
-                {
-                    return o<<c(0x1A)<<static_cast<std::uint32_t>(v);
-                }
-                else// this never happens
-                {
-                    return o<<c(0x1B)<<static_cast<std::uint64_t>(v);
-                }
-            }
-            else
-            {
-                // The conversions below encode the sign in the first
-                // byte, and the value is converted to a positive number.
-                const auto n = -1 - v;
-                if (v >= -24)
-                {
-                    return o<<static_cast<std::uint8_t>(0x20 + n);
-                }
-                else if (n <= (std::numeric_limits<std::uint8_t>::max)())
-                {
-                    return o<<c(0x38)<<static_cast<std::uint8_t>(n);
-                }
-                else if (n <= (std::numeric_limits<std::uint16_t>::max)())
-                {
-                    return o<<c(0x39)<<static_cast<std::uint16_t>(n);
-                }
-                else if (n <= (std::numeric_limits<std::uint32_t>::max)())
-                {
-                    return o<<c(0x3A)<<static_cast<std::uint32_t>(n);
-                }
-                else
-                {
-                    return o<<c(0x3B)<<static_cast<std::uint64_t>(n);
-                }
-            }
-        }
+            return dumpInteger(o,var.as<int>());
+
+        if(var.is<int64_t>())
+            return dumpInteger(o,var.as<int64_t>());
 
         if(var.is<SvarBuffer>()){
             SvarBuffer& s=var.as<SvarBuffer>();
@@ -362,13 +381,13 @@ public:
             // step 2: write each element
             for (const auto& el : obj)
             {
-                dumpStream(o,el.first);
+                dumpStream(o,el.first.str());
                 dumpStream(o,el.second);
             }
             return o;
         }
 
-        Svar func_buffer=var.classObject()._attr["__buffer__"];
+        Svar func_buffer=var.classObject().attributes()["__buffer__"];
         if(func_buffer.isFunction()){
             dumpStream(o,func_buffer(var));
         }
@@ -47,7 +47,7 @@ public:
         SvarClass& cls=src.as<SvarClass>();
 
         std::vector<PropertyDescriptor> properties;
-        for(std::pair<std::string,Svar> kv:cls._attr){
+        for(std::pair<std::string,Svar> kv:cls.attributes()){
             if(kv.second.isFunction()){
                 SvarFunction& func=kv.second.as<SvarFunction>();
                 func.name=kv.first;
@@ -72,7 +72,7 @@ public:
         std::shared_ptr<FunctionReference> constructor=std::make_shared<FunctionReference>();
         *constructor= Napi::Persistent(func);
         constructor->SuppressDestruct();
-        cls._attr["__js_constructor"]=constructor;
+        cls.setAttr("__js_constructor",constructor);
         return func;
     }
 
@@ -181,7 +181,7 @@ public:
             std::shared_ptr<FunctionReference> funcref=std::make_shared<FunctionReference>();
             *funcref= Napi::Persistent(func);
             SvarFunction svarfunc;
-            svarfunc._func=[funcref](std::vector<Svar>& args)->Svar{
+            svarfunc._func=[funcref](SvarArgs& args)->Svar{
                 // TODO: How to be thead safe?
                 std::vector<napi_value> info;
                 for(auto& arg:args)
@@ -258,7 +258,7 @@ public:
             convert=&SvarJS::getNodeClass;
         else
             convert=[](Napi::Env env,Svar src)->Napi::Value{
-                Svar js_constructor = src.classPtr()->_attr["__js_constructor"];
+                Svar js_constructor = src.classPtr()->attributes()["__js_constructor"];
                 Object obj;
                 if(!js_constructor.is<FunctionReference>()){
                     obj=getNodeClass(env,src.classObject()).As<Function>().New({});
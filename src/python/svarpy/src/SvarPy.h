@@ -133,6 +133,9 @@ struct SvarPy: public PyObject{
         case sv::integer_t:
             return PyObjectHolder(PyLong_FromLong(src.as<int>()),false);
             break;
+        case sv::integer64_t:
+            return PyObjectHolder(PyLong_FromLongLong(src.as<int64_t>()),false);
+            break;
         case sv::float_t:
             return PyObjectHolder(PyFloat_FromDouble(src.as<double>()),false);
             break;
@@ -202,7 +205,7 @@ struct SvarPy: public PyObject{
         SvarFunction& svarFunc = func->as<SvarFunction>();
 
         try{
-            std::vector<Svar> svar_args;
+            SvarArgs svar_args;
             int nargs=PyTuple_Size(args);
             svar_args.reserve(nargs);
             for(Py_ssize_t i=0;i<nargs;++i)
@@ -281,10 +284,10 @@ struct SvarPy: public PyObject{
             return (PyTypeObject*)Py_None;
         }
 
-        heap_type->ht_name = SVAR_FROM_STRING(cls.__name__.c_str());
+        heap_type->ht_name = SVAR_FROM_STRING(cls.name().c_str());
 
         PyTypeObject* type = &heap_type->ht_type;
-        type->tp_name = cls.__name__.c_str();
+        type->tp_name = cls.name().c_str();
         type->tp_base = type_incref(&PyBaseObject_Type);// FIXME: Why cause segment fault help when inherit svar_object
         type->tp_basicsize=sizeof(SvarPy);
         type->tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HEAPTYPE;
@@ -293,7 +296,7 @@ struct SvarPy: public PyObject{
         type->tp_as_sequence = &heap_type->as_sequence;
         type->tp_as_mapping = &heap_type->as_mapping;
 
-        const SvarObject& attr = cls._attr.as<SvarObject>();
+        const SvarObject& attr = cls.attributes().as<SvarObject>();
         if(attr["__buffer__"].isFunction()){
           type->tp_as_buffer= & heap_type->as_buffer;
           heap_type->as_buffer.bf_getbuffer=[](PyObject *obj, Py_buffer *view, int flags)->int{
@@ -355,7 +358,7 @@ struct SvarPy: public PyObject{
         if (PyType_Ready(type) < 0)
             LOG(ERROR)<<("make_static_property_type(): failure in PyType_Ready()!");
 
-        for(std::pair<std::string,Svar> f:cls._attr)
+        for(std::pair<std::string,Svar> f:cls.attributes())
         {
             if(f.first == "__init__"){
                 SvarFunction& func_old = f.second.as<SvarFunction>();
@@ -367,10 +370,10 @@ struct SvarPy: public PyObject{
                 func_new.arg_types = func_old.arg_types;
                 func_new.kwargs = func_old.kwargs;
                 func_new.do_argcheck=false;
-                func_new._func  = [f,type](std::vector<Svar> args){
+                func_new._func  = [f,type](SvarArgs& args){
                     PyObject *self = type->tp_alloc(type, 0);
                     SvarPy* obj = reinterpret_cast<SvarPy*>(self);
-                    std::vector<Svar> argv(args.begin()+1,args.end());
+                    SvarArgs argv(args.begin()+1,args.end());
                     obj->var = new Svar(f.second.as<SvarFunction>().Call(argv));
                     return PyObjectHolder(obj,false);
                 };
@@ -409,7 +412,11 @@ struct SvarPy: public PyObject{
             lut[&_PyNone_Type] =[](PyObject* o)->Svar{return Svar::Null();};
             lut[&PyBool_Type] =[](PyObject* o)->Svar{return (bool)PyLong_AsLong(o);};
             lut[&PyFloat_Type]=[](PyObject* o)->Svar{return PyFloat_AsDouble(o);};
-            lut[&PyLong_Type] =[](PyObject* o)->Svar{return (int)PyLong_AsLong(o);};
+            lut[&PyLong_Type] =[](PyObject* o)->Svar{
+                long long v=PyLong_AsLongLong(o);
+                if(v>=std::numeric_limits<int>::min()&&v<=std::numeric_limits<int>::max()) return (int)v;
+                return (int64_t)v;
+            };
 
             lut[&PyUnicode_Type] =[](PyObject* obj)->Svar{
                 PyObjectHolder buf(PyUnicode_AsUTF8String(obj),false);
@@ -454,9 +461,9 @@ struct SvarPy: public PyObject{
                 SvarFunction func;
 
                 Svar holder=PyObjectHolder(incref(obj));
-                func._func=[holder](std::vector<Svar>& args)->Svar{
+                func._func=[holder](SvarArgs& args)->Svar{
                     PyThreadStateLock PyThreadLock;
-                    PyObjectHolder py_args=SvarPy::getPy(args);
+                    PyObjectHolder py_args=SvarPy::getPy(std::vector<Svar>(args.begin(),args.end()));
                     return SvarPy::fromPy(PyObject_Call(holder.as<PyObjectHolder>().obj, py_args.obj, nullptr));
                 };
                 func.do_argcheck=false;
@@ -468,9 +475,9 @@ struct SvarPy: public PyObject{
                 //                if(capsule) incref(capsule);
                 SvarFunction func;
                 Svar holder=PyObjectHolder(obj);
-                func._func=[holder](std::vector<Svar>& args)->Svar{
+                func._func=[holder](SvarArgs& args)->Svar{
                     PyThreadStateLock PyThreadLock;
-                    PyObjectHolder py_args=SvarPy::getPy(args);
+                    PyObjectHolder py_args=SvarPy::getPy(std::vector<Svar>(args.begin(),args.end()));
                     return SvarPy::fromPy(PyCFunction_Call(holder.as<PyObjectHolder>().obj, py_args.obj,nullptr));
                 };
                 func.do_argcheck=false;
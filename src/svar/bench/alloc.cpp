@@ -0,0 +1,82 @@
+#include "bench.h"
+#include <atomic>
+#include <new>
+
+using namespace sv;
+
+static std::atomic<size_t> alloc_count(0),alloc_bytes(0);
+
+// Count every allocation made by this binary, the overhead is a relaxed increment.
+void* operator new(size_t sz){
+    alloc_count.fetch_add(1,std::memory_order_relaxed);
+    alloc_bytes.fetch_add(sz,std::memory_order_relaxed);
+    if(void* p=std::malloc(sz?sz:1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+size_t bench::allocations(){
+    return alloc_count.load(std::memory_order_relaxed);
+}
+
+size_t bench::allocated_bytes(){
+    return alloc_bytes.load(std::memory_order_relaxed);
+}
+
+int bench_alloc(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of values to create");
+    if(config.get("help",false)) return config.help();
+
+    std::string json;
+    {
+        std::stringstream sst;
+        sst<<"[";
+        for(int i=0;i<n;i++) sst<<(i?",":"")<<i<<","<<i*0.5;
+        sst<<"]";
+        json=sst.str();
+    }
+
+    bench::report("make_shared<int> (baseline)",bench::measure([n](){
+        std::vector<Svar> vec;
+        vec.reserve(n);
+        for(int i=0;i<n;i++)
+            vec.push_back(Svar(std::shared_ptr<SvarValue>(std::make_shared<SvarValue_<int>>(i))));
+    }),n);
+
+    bench::report("Svar(int)",bench::measure([n](){
+        std::vector<Svar> vec;
+        vec.reserve(n);
+        for(int i=0;i<n;i++) vec.push_back(Svar(i));
+    }),n);
+
+    bench::report("Svar(double)",bench::measure([n](){
+        std::vector<Svar> vec;
+        vec.reserve(n);
+        for(int i=0;i<n;i++) vec.push_back(Svar(i*0.5));
+    }),n);
+
+    bench::report("Svar(short string)",bench::measure([n](){
+        std::vector<Svar> vec;
+        vec.reserve(n);
+        for(int i=0;i<n;i++) vec.push_back(Svar(std::to_string(i)));
+    }),n);
+
+    bench::report("Json::load numbers",bench::measure([&json](){
+        Svar::parse_json(json);
+    }),2*n);
+
+    bench::report("Json::load numbers (arena)",bench::measure([&json](){
+        SvarArena arena;
+        Svar::parse_json(json);
+    }),2*n);
+
+    std::cout<<SvarArena::stats()<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_alloc){
+    svar["apps"]["bench_alloc"]={bench_alloc,"Benchmark allocations of scalar values"};
+}
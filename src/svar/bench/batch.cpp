@@ -0,0 +1,44 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_batch(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of items");
+    int threads=config.arg<int>("threads",4,"the number of threads for buffers");
+    if(config.get("help",false)) return config.help();
+
+    Svar func([](double x){return x*0.5+1;});
+    const SvarFunction& f=func.as<SvarFunction>();
+
+    Svar array=Svar::array();
+    std::vector<double> values(n);
+    for(int i=0;i<n;i++){
+        array.push_back(i);
+        values[i]=i;
+    }
+    Svar buffer=SvarBuffer(values.data(),std::vector<ssize_t>({n}));
+
+    double sum=0;
+    bench::report("call per item",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=func(array[i]).as<double>();
+    }),n);
+
+    bench::report("map array",bench::measure([&](){
+        sum+=f.map(array)[n-1].as<double>();
+    }),n);
+
+    bench::report("map buffer",bench::measure([&](){
+        sum+=f.map(buffer).as<SvarBuffer>().ptr<double>()[n-1];
+    }),n);
+
+    bench::report("map buffer threads",bench::measure([&](){
+        sum+=f.map(buffer,threads).as<SvarBuffer>().ptr<double>()[n-1];
+    }),n);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_batch){
+    svar["apps"]["bench_batch"]={bench_batch,"Benchmark SvarFunction::map over arrays and buffers"};
+}
@@ -0,0 +1,35 @@
+#ifndef SVAR_BENCH_H
+#define SVAR_BENCH_H
+
+#include "Svar.h"
+#include "Timer.h"
+#include <iomanip>
+
+namespace bench {
+
+/// Number of global operator new calls since program start, see alloc.cpp
+size_t allocations();
+
+/// Number of bytes requested from global operator new since program start
+size_t allocated_bytes();
+
+/// Run func and return the cost in seconds together with the allocations made
+template <typename Func>
+std::pair<double,size_t> measure(Func func){
+    size_t allocs=allocations();
+    GSLAM::TicToc tictoc;
+    func();
+    double cost=tictoc.Tac();
+    return std::make_pair(cost,allocations()-allocs);
+}
+
+inline void report(const std::string& name,std::pair<double,size_t> r,size_t n){
+    std::cout<<std::left<<std::setw(32)<<name
+             <<std::setw(12)<<r.first*1e3<<"ms "
+             <<std::setw(10)<<r.first*1e9/n<<"ns/op "
+             <<std::setw(10)<<(double)r.second/n<<"allocs/op"<<std::endl;
+}
+
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_call(Svar config){
+    int n=config.arg<int>("n",10000000,"the number of calls to run");
+    if(config.get("help",false)) return config.help();
+
+    Svar add([](int a,int b){return a+b;});
+    Svar max6([](int a,int b,int c,int d,int e,int f){
+        return std::max(std::max(std::max(a,b),std::max(c,d)),std::max(e,f));
+    });
+
+    long long sum=0;
+    bench::report("int(int,int)",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=add(i,1).as<int>();
+    }),n);
+
+    TypedFunction<int(int,int)> typed=add;
+    bench::report("TypedFunction<int(int,int)>",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=typed(i,1);
+    }),n);
+
+    Svar module;
+    module.def("add",[](int a,int b){return a+b;},"a"_a,"b"_a=0);
+    Svar kwadd=module["add"],b=("b"_a=1);
+    bench::report("int(int,int) default b",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=kwadd(i).as<int>();
+    }),n);
+
+    bench::report("int(int,int) keyword b",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=kwadd(i,b).as<int>();
+    }),n);
+
+    bench::report("int(int x6)",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=max6(i,1,2,3,4,5).as<int>();
+    }),n);
+
+    SvarFunction::setProfiling(true);
+    bench::report("int(int,int) profiled",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=add(i,1).as<int>();
+    }),n);
+    SvarFunction::setProfiling(false);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_call){
+    svar["apps"]["bench_call"]={bench_call,"Benchmark calling a bound function"};
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+
+using namespace sv;
+
+static Svar make_tree(int depth,int fanout,size_t& nodes){
+    nodes++;
+    if(depth==0) return (int)nodes;
+    Svar obj=Svar::object();
+    for(int i=0;i<fanout;i++)
+        obj["n"+std::to_string(i)]=make_tree(depth-1,fanout,nodes);
+    return obj;
+}
+
+int bench_clone(Svar config){
+    int depth=config.arg<int>("depth",5,"the depth of the cloned tree");
+    int fanout=config.arg<int>("fanout",10,"the number of children of each node");
+    int n=config.arg<int>("n",20,"the number of clones to make");
+    int touch=config.arg<int>("touch",8,"the number of leaves written in each clone");
+    if(config.get("help",false)) return config.help();
+
+    size_t nodes=0;
+    Svar tree=make_tree(depth,fanout,nodes);
+    std::cout<<"tree nodes: "<<nodes<<std::endl;
+
+    std::vector<Svar> clones;
+    auto modify=[&](Svar c){
+        for(int t=0;t<touch;t++){
+            Svar node=c;
+            for(int d=0;d<depth-1;d++) node=node["n"+std::to_string((t*7+d)%fanout)];
+            node["n0"]=-t;
+        }
+    };
+
+    // walking every node checks that the whole tree was copied
+    std::function<size_t(const Svar&)> walk=[&](const Svar& node){
+        size_t count=1;
+        if(node.isObject())
+            for(std::pair<std::string,Svar> it:node) count+=walk(it.second);
+        return count;
+    };
+    bench::report("clone + full walk",bench::measure([&](){
+        for(int i=0;i<n;i++){
+            Svar c=tree.clone(depth+1);
+            if(walk(c)!=nodes) std::cerr<<"broken clone"<<std::endl;
+            clones.push_back(c);
+        }
+    }),n);
+    clones.clear();
+
+    bench::report("clone",bench::measure([&](){
+        for(int i=0;i<n;i++) clones.push_back(tree.clone(depth+1));
+    }),n);
+    clones.clear();
+
+    bench::report("clone + touch "+std::to_string(touch)+" leaves",bench::measure([&](){
+        for(int i=0;i<n;i++){
+            Svar c=tree.clone(depth+1);
+            modify(c);
+            clones.push_back(c);
+        }
+    }),n);
+
+    std::cout<<"original untouched: "<<(tree["n0"]["n0"]["n0"]["n0"]["n0"].as<int>()>0)<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_clone){
+    svar["apps"]["bench_clone"]={bench_clone,"Benchmark deep clones of a large tree"};
+}
@@ -0,0 +1,41 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_dict(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of lookups to run");
+    int keys=config.arg<int>("keys",1000,"the number of keys in the dict");
+    if(config.get("help",false)) return config.help();
+
+    std::vector<Svar> int_keys,string_keys;
+    for(int i=0;i<keys;i++){
+        int_keys.push_back(i);
+        string_keys.push_back("key"+std::to_string(i));
+    }
+
+    size_t hits=0;
+    for(auto* names:{&int_keys,&string_keys}){
+        std::string kind=names==&int_keys?"int":"string";
+        std::map<Svar,Svar> tree;
+        SvarDict::map_type table;
+        for(auto& k:*names){
+            tree[k]=k;
+            table[k]=k;
+        }
+
+        bench::report("std::map "+kind+" (baseline)",bench::measure([&](){
+            for(int i=0;i<n;i++) hits+=tree.find((*names)[i%keys])!=tree.end();
+        }),n);
+
+        bench::report("SvarDict "+kind,bench::measure([&](){
+            for(int i=0;i<n;i++) hits+=table.find((*names)[i%keys])!=table.end();
+        }),n);
+    }
+
+    std::cout<<"hits: "<<hits<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_dict){
+    svar["apps"]["bench_dict"]={bench_dict,"Benchmark dict lookups"};
+}
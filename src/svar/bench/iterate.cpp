@@ -0,0 +1,47 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_iterate(Svar config){
+    int n=config.arg<int>("n",100000,"the number of loops to run");
+    int size=config.arg<int>("size",10,"the number of items in each container");
+    if(config.get("help",false)) return config.help();
+
+    Svar array=Svar::array(),object=Svar::object();
+    for(int i=0;i<size;i++){
+        array.push_back(i);
+        object["key"+std::to_string(i)]=i;
+    }
+
+    long long sum=0;
+    bench::report("array range-for",bench::measure([&](){
+        for(int i=0;i<n;i++) for(auto v:array) sum+=v.as<int>();
+    }),n);
+
+    bench::report("array values()",bench::measure([&](){
+        for(int i=0;i<n;i++) for(const Svar& v:array.values()) sum+=v.as<int>();
+    }),n);
+
+    bench::report("array values(lock)",bench::measure([&](){
+        for(int i=0;i<n;i++) for(const Svar& v:array.values(true)) sum+=v.as<int>();
+    }),n);
+
+    bench::report("object range-for",bench::measure([&](){
+        for(int i=0;i<n;i++) for(std::pair<std::string,Svar> it:object) sum+=it.second.as<int>();
+    }),n);
+
+    bench::report("object items()",bench::measure([&](){
+        for(int i=0;i<n;i++) for(const auto& it:object.items()) sum+=it.second.as<int>();
+    }),n);
+
+    bench::report("object values(lock)",bench::measure([&](){
+        for(int i=0;i<n;i++) for(const Svar& v:object.values(true)) sum+=v.as<int>();
+    }),n);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_iterate){
+    svar["apps"]["bench_iterate"]={bench_iterate,"Benchmark iterating arrays and objects"};
+}
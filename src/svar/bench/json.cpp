@@ -0,0 +1,208 @@
+#include "bench.h"
+
+using namespace sv;
+
+namespace {
+
+/// Statuses with nested users, long texts and unicode escapes, like twitter.json
+std::string twitter_like(int n){
+    std::string json="{\"statuses\":[";
+    for(int i=0;i<n;i++){
+        if(i) json+=",";
+        std::string id=std::to_string(505874924095815681LL+i);
+        json+="\n  {\n    \"created_at\": \"Sun Aug 31 00:29:15 +0000 2014\",\n"
+              "    \"id\": "+id+",\n    \"id_str\": \""+id+"\",\n"
+              "    \"text\": \"@aym0566x \\n\\u540d\\u524d:\\u524d\\u7530\\u3042\\u3086\\u307f\\n"
+              "\\u7b2c\\u4e00\\u5370\\u8c61:\\u306a\\u3093\\u304b\\u6016\\u3063\\uff01 "
+              "caf\\u00e9 \\ud83d\\ude00 http:\\/\\/t.co\\/lbKZSpRpJz\",\n"
+              "    \"source\": \"<a href=\\\"https:\\/\\/mobile.twitter.com\\\" rel=\\\"nofollow\\\">Mobile Web (M2)<\\/a>\",\n"
+              "    \"truncated\": false,\n    \"in_reply_to_status_id\": null,\n"
+              "    \"user\": {\n      \"id\": 1186275104,\n      \"name\": \"AYUMI\",\n"
+              "      \"screen_name\": \"ayuu0123\",\n      \"location\": \"\",\n"
+              "      \"description\": \"\\u5143\\u91ce\\u7403\\u90e8\\u30de\\u30cd\\u30fc\\u30b8\\u30e3\\u30fc\\u2764\\ufe0e\",\n"
+              "      \"followers_count\": 262,\n      \"friends_count\": 252,\n"
+              "      \"profile_image_url\": \"http:\\/\\/pbs.twimg.com\\/profile_images\\/497760886795153410\\/LDjAwR_y_normal.jpeg\",\n"
+              "      \"verified\": false\n    },\n"
+              "    \"retweet_count\": 0,\n    \"favorite_count\": 0,\n"
+              "    \"entities\": {\"hashtags\": [], \"urls\": [], \"user_mentions\": [{\"screen_name\": \"aym0566x\", \"indices\": [0, 9]}]},\n"
+              "    \"lang\": \"ja\"\n  }";
+    }
+    json+="\n]}";
+    return json;
+}
+
+/// Long arrays of coordinates with full precision doubles, like canada.json
+std::string canada_like(int n){
+    std::string json="{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"geometry\":"
+                     "{\"type\":\"Polygon\",\"coordinates\":[[";
+    char buf[64];
+    for(int i=0;i<n;i++){
+        snprintf(buf,sizeof(buf),"%s[%.15g,%.15g]",i?",":"",-65.613616999999977+i*1e-5,43.420273000000009-i*1e-5);
+        json+=buf;
+    }
+    json+="]]}}]}";
+    return json;
+}
+
+/// Pretty printed nested objects with short keys and values, like a config file
+std::string config_like(int n){
+    Svar config;
+    for(int i=0;i<n;i++){
+        Svar section;
+        section["enabled"]=(i%2==0);
+        section["name"]="section_"+std::to_string(i);
+        section["path"]="/usr/share/data/section_"+std::to_string(i)+"/config.yaml";
+        section["threads"]=4;
+        section["scale"]=0.5;
+        section["camera"]["width"]=640;
+        section["camera"]["height"]=480;
+        section["camera"]["distortion"]=Svar({0.1,-0.2,0.001,0.0});
+        section["camera"]["model"]="PinHole";
+        config["section_"+std::to_string(i)]=section;
+    }
+    return config.dump_json(2);
+}
+
+/// Long strings such as embedded logs or base64 blobs, where scanning dominates
+std::string strings_like(int n){
+    std::string line;
+    for(int i=0;line.size()<1000;i++) line+="QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVphYmNkZWZnaGlqa2xtbm9wcXJzdHV2d3h5ejAxMjM0NTY3ODk"[i%80];
+    std::string json="[";
+    for(int i=0;i<n;i++) json+=(i?",\n  \"":"\n  \"")+line+"\"";
+    json+="\n]";
+    return json;
+}
+
+/// One compact status per line, like an event log
+std::string events_like(int n){
+    Svar statuses=Json::load(twitter_like(n))["statuses"];
+    std::string json;
+    for(const Svar& status:statuses.as<SvarArray>()._var)
+        json+=status.dump_json()+"\n";
+    return json;
+}
+
+/// Sums user.followers_count of all statuses and skips every other value
+class FollowerCounter : public Json::Handler{
+public:
+    int64_t followers=0;
+    int     depth=0;
+    bool    wanted=false;
+
+    Action startObject(){depth++;return CONTINUE;}
+    Action endObject(){depth--;return CONTINUE;}
+    Action key(const std::string& name){
+        if(depth==1) return CONTINUE;
+        if(depth==2) return name=="user"?CONTINUE:SKIP;
+        wanted=name=="followers_count";
+        return wanted?CONTINUE:SKIP;
+    }
+    Action integer(int64_t value){
+        if(wanted) followers+=value;
+        return CONTINUE;
+    }
+};
+
+void throughput(const std::string& name,std::pair<double,size_t> r,size_t bytes){
+    std::cout<<std::left<<std::setw(32)<<name
+             <<std::setw(12)<<r.first*1e3<<"ms "
+             <<std::setw(10)<<bytes/r.first*1e-9<<"GB/s "
+             <<std::setw(10)<<(double)r.second*(1<<20)/bytes<<"allocs/MB"<<std::endl;
+}
+
+}
+
+int bench_json(Svar config){
+    int size=config.arg<int>("size",10000,"the number of items in each corpus");
+    int repeat=config.arg<int>("repeat",5,"the number of times to parse each corpus");
+    int threads=config.arg<int>("threads",std::thread::hardware_concurrency(),"the most threads for Json::loadLines");
+    if(config.get("help",false)) return config.help();
+
+    std::vector<std::pair<std::string,std::string>> corpora={{"twitter",twitter_like(size)},
+                                                              {"canada",canada_like(10*size)},
+                                                              {"config",config_like(size)},
+                                                              {"strings",strings_like(size)}};
+    const char* levels[]={"scalar","sse2","avx2"};
+    int best=detail::json_scan::level();
+
+    size_t count=0;
+    for(auto& corpus:corpora){
+        const std::string& json=corpus.second;
+        for(int level=0;level<=best;level++){
+            detail::json_scan::level()=level;
+            throughput(corpus.first+" ("+levels[level]+")",bench::measure([&](){
+                for(int i=0;i<repeat;i++) count+=Json::load(json.data(),json.size()).length();
+            }),json.size()*repeat);
+        }
+        detail::json_scan::level()=best;
+    }
+
+    std::string json=corpora.front().second;
+    SvarBuffer buffer(json.data(),json.size());
+    if(Json::load(json).dump_json()!=Json::load(buffer).dump_json()) return -1;
+
+    int64_t followers=0;
+    throughput("followers (load)",bench::measure([&](){
+        for(int i=0;i<repeat;i++){
+            Svar statuses=Json::load(json)["statuses"];
+            for(const Svar& status:statuses.as<SvarArray>()._var)
+                followers+=status["user"]["followers_count"].as<int>();
+        }
+    }),json.size()*repeat);
+
+    throughput("followers (Handler)",bench::measure([&](){
+        for(int i=0;i<repeat;i++){
+            FollowerCounter counter;
+            Json::parse(json,counter);
+            followers-=counter.followers;
+        }
+    }),json.size()*repeat);
+
+    std::string events=events_like(size);
+    size_t lines=0;
+    throughput("events (load per line)",bench::measure([&](){
+        for(int i=0;i<repeat;i++){
+            for(size_t pos=0,end;pos<events.size();pos=end+1){
+                end=events.find('\n',pos);
+                lines+=Json::load(events.data()+pos,end-pos).length();
+            }
+        }
+    }),events.size()*repeat);
+
+    for(size_t chunk:{(size_t)256,(size_t)4096,(size_t)65536}){
+        size_t pending=0,values=0;
+        throughput("events (Stream "+std::to_string(chunk)+")",bench::measure([&](){
+            for(int i=0;i<repeat;i++){
+                Json::Stream stream([&](const Svar& v){values+=v.length();});
+                for(size_t pos=0;pos<events.size();pos+=chunk){
+                    stream.push(events.data()+pos,std::min(chunk,events.size()-pos));
+                    pending=std::max(pending,stream.pending());
+                }
+                stream.finish();
+            }
+        }),events.size()*repeat);
+        std::cout<<"max pending bytes: "<<pending<<", mismatch: "<<lines-values<<std::endl;
+    }
+
+    // scaling of Json::loadLines from one thread to all cores
+    std::vector<int> counts;
+    for(int n=1;n<threads;n*=2) counts.push_back(n);
+    counts.push_back(std::max(threads,1));
+    double single=0;
+    for(int n:counts){
+        size_t values=0;
+        auto r=bench::measure([&](){
+            for(int i=0;i<repeat;i++) values+=Json::loadLines(events.data(),events.size(),n).length();
+        });
+        if(n==1) single=r.first;
+        throughput("events (loadLines "+std::to_string(n)+" threads)",r,events.size()*repeat);
+        std::cout<<"speedup: "<<single/r.first<<", mismatch: "<<(size_t)size*repeat-values<<std::endl;
+    }
+
+    std::cout<<"items: "<<count<<", followers mismatch: "<<followers<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_json){
+    svar["apps"]["bench_json"]={bench_json,"Benchmark json parsing throughput"};
+}
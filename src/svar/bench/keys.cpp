@@ -0,0 +1,45 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_keys(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of lookups to run");
+    int objects=config.arg<int>("objects",10000,"the number of objects in the json document");
+    if(config.get("help",false)) return config.help();
+
+    std::vector<std::string> names={"name","id","type","width","height","enabled","children","parent"};
+    std::vector<SvarKey> keys;
+    for(auto& name:names) keys.push_back(SvarKey(name));
+
+    Svar obj;
+    for(size_t i=0;i<names.size();i++) obj[names[i]]=(int)i;
+
+    size_t hits=0;
+    bench::report("operator[](string)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=obj[names[i&7]].is<int>();
+    }),n);
+
+    bench::report("operator[](SvarKey)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=obj[keys[i&7]].is<int>();
+    }),n);
+
+    bench::report("get<int>(string)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=obj.get<int>(names[i&7],0);
+    }),n);
+
+    bench::report("get<int>(SvarKey)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=obj.get<int>(keys[i&7],0);
+    }),n);
+
+    std::string json=Svar(std::vector<Svar>(objects,obj)).dump_json();
+    bench::report("Json::load objects",bench::measure([&](){
+        hits+=Svar::parse_json(json).length();
+    }),objects);
+
+    std::cout<<"hits: "<<hits<<", interned keys: "<<SvarKey::count()<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_keys){
+    svar["apps"]["bench_keys"]={bench_keys,"Benchmark object key lookups"};
+}
@@ -0,0 +1,49 @@
+#include "bench.h"
+
+using namespace sv;
+
+struct MethodBase{
+    int x=1;
+    int get()const{return x;}
+};
+
+struct MethodDerived:public MethodBase{
+    int own()const{return x+1;}
+};
+
+int bench_method(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of calls to run");
+    if(config.get("help",false)) return config.help();
+
+    Class<MethodBase>("MethodBase").def("get",&MethodBase::get);
+    Class<MethodDerived>("MethodDerived")
+            .inherit<MethodBase>()
+            .def_static("__init__",[](){return MethodDerived();})
+            .def("own",&MethodDerived::own);
+    Svar obj=svar["MethodDerived"]();
+
+    long long sum=0;
+    bench::report("call(\"own\")",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=obj.call("own").as<int>();
+    }),n);
+
+    bench::report("call(\"get\") inherited",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=obj.call("get").as<int>();
+    }),n);
+
+    CallSite own("own"),get("get");
+    bench::report("CallSite own",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=own(obj).as<int>();
+    }),n);
+
+    bench::report("CallSite get inherited",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=get(obj).as<int>();
+    }),n);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_method){
+    svar["apps"]["bench_method"]={bench_method,"Benchmark calling methods by name"};
+}
@@ -0,0 +1,78 @@
+#include "bench.h"
+
+using namespace sv;
+
+typedef std::unordered_map<std::string,Svar> string_map;
+
+int bench_object(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of lookups for each size");
+    int objects=config.arg<int>("objects",10000,"the number of objects for memory usage");
+    if(config.get("help",false)) return config.help();
+
+    typedef SvarObject::map_type::chunk chunk;
+    std::cout<<std::left<<std::setw(6)<<"keys"
+             <<std::setw(16)<<"map bytes"<<std::setw(16)<<"object bytes"
+             <<std::setw(16)<<"map find ns"<<std::setw(16)<<"object find ns"<<std::endl;
+
+    for(int keys:{1,2,4,8,12,16,32,64}){
+        std::vector<std::string> names;
+        std::vector<SvarKey>     atoms;
+        for(int i=0;i<keys;i++){
+            names.push_back("key"+std::to_string(i));
+            atoms.push_back(SvarKey(names.back()));
+        }
+
+        // heap usage per object with the values excluded, they are the same for both
+        std::vector<Svar> holder;
+        holder.reserve(objects);
+        Svar value(0);
+        size_t bytes=bench::allocated_bytes();
+        for(int i=0;i<objects;i++){
+            string_map m;
+            for(auto& name:names) m[name]=value;
+            holder.push_back(Svar::create(std::move(m)));
+        }
+        double map_bytes=(double)(bench::allocated_bytes()-bytes)/objects;
+        holder.clear();
+
+        // the first round fills the node pool, the second one is measured
+        for(int round=0;round<2;round++){
+            holder.clear();
+            bytes=bench::allocated_bytes();
+            for(int i=0;i<objects;i++){
+                SvarObject::map_type m;
+                for(auto& atom:atoms) m[atom]=value;
+                holder.push_back((std::shared_ptr<SvarValue>)std::make_shared<SvarObject>(std::move(m)));
+            }
+        }
+        // chunks come from the node pool and are not seen by operator new
+        double object_bytes=(double)(bench::allocated_bytes()-bytes)/objects
+                +sizeof(chunk)*std::min<int>((keys+3)/4,3);
+        holder.clear();
+
+        string_map m;
+        SvarObject::map_type o;
+        for(int i=0;i<keys;i++){
+            m[names[i]]=i;
+            o[atoms[i]]=i;
+        }
+
+        size_t hits=0;
+        auto map_find=bench::measure([&](){
+            for(int i=0;i<n;i++) hits+=m.find(names[i%keys])!=m.end();
+        });
+        auto object_find=bench::measure([&](){
+            for(int i=0;i<n;i++) hits+=o.find(atoms[i%keys])!=o.end();
+        });
+        if(hits!=2*(size_t)n) return -1;
+
+        std::cout<<std::setw(6)<<keys
+                 <<std::setw(16)<<map_bytes<<std::setw(16)<<object_bytes
+                 <<std::setw(16)<<map_find.first*1e9/n<<std::setw(16)<<object_find.first*1e9/n<<std::endl;
+    }
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_object){
+    svar["apps"]["bench_object"]={bench_object,"Benchmark memory and lookups of small objects"};
+}
@@ -0,0 +1,54 @@
+#include "bench.h"
+
+using namespace sv;
+
+struct Vec2{
+    double x,y;
+};
+
+int bench_operator(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of expressions to evaluate");
+    if(config.get("help",false)) return config.help();
+
+    SvarClass::Class<Vec2>()
+            .def("__add__",[](const Vec2& a,const Vec2& b){return Vec2{a.x+b.x,a.y+b.y};});
+
+    Svar one(1),half(0.5),limit(1000);
+    double sum=0;
+    bench::report("int: (i+1)*2-i",bench::measure([&](){
+        for(int i=0;i<n;i++){
+            Svar v(i);
+            sum+=((v+one)*Svar(2)-v).as<int>();
+        }
+    }),n);
+
+    bench::report("double: x*0.5+1.0",bench::measure([&](){
+        Svar x(1.);
+        for(int i=0;i<n;i++) x=x*half+one;
+        sum+=x.as<double>();
+    }),n);
+
+    bench::report("compare: i<1000, i==1000",bench::measure([&](){
+        for(int i=0;i<n;i++){
+            Svar v(i);
+            sum+=(v<limit)+(v==limit);
+        }
+    }),n);
+
+    Svar a("svar"),b("bench");
+    bench::report("str: a+b, a==b",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=(a+b).length()+(a==b);
+    }),n);
+
+    Svar p=Vec2{1,2},q=Vec2{3,4};
+    bench::report("user class __add__",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=(p+q).as<Vec2>().x;
+    }),n);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_operator){
+    svar["apps"]["bench_operator"]={bench_operator,"Benchmark operators on builtin values and user classes"};
+}
@@ -0,0 +1,45 @@
+#include "bench.h"
+
+using namespace sv;
+
+struct OverloadFirst{};
+struct OverloadSecond{};
+
+int bench_overload(Svar config){
+    int n=config.arg<int>("n",1000000,"the number of calls to run");
+    if(config.get("help",false)) return config.help();
+
+    Svar single([](int x){return x;});
+    Svar f([](OverloadFirst&){return 1;});
+    f.overload([](OverloadSecond&){return 2;});
+    f.overload([](int x){return x;});
+
+    size_t sum=0;
+    bench::report("single function",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=single(i).as<int>();
+    }),n);
+
+    bench::report("third overload",bench::measure([&](){
+        for(int i=0;i<n;i++) sum+=f(i).as<int>();
+    }),n);
+
+    Svar object=Svar::object();
+    bench::report("failed castAs (throws)",bench::measure([&](){
+        for(int i=0;i<n;i++){
+            try{sum+=object.castAs<std::string>().size();}
+            catch(SvarExeption&){}
+        }
+    }),n);
+
+    bench::report("failed tryCast",bench::measure([&](){
+        std::string str;
+        for(int i=0;i<n;i++) sum+=object.tryCast(str);
+    }),n);
+
+    std::cout<<"sum: "<<sum<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_overload){
+    svar["apps"]["bench_overload"]={bench_overload,"Benchmark calling overloaded functions"};
+}
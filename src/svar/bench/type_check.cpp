@@ -0,0 +1,47 @@
+#include "bench.h"
+
+using namespace sv;
+
+int bench_type_check(Svar config){
+    int n=config.arg<int>("n",10000000,"the number of checks to run");
+    if(config.get("help",false)) return config.help();
+
+    std::vector<Svar> values={1,2.,true,"str",Svar::object(),Svar::array(),Svar::dict(),Svar()};
+    size_t hits=0;
+
+    bench::report("dynamic_pointer_cast (baseline)",bench::measure([&](){
+        for(int i=0;i<n;i++)
+            hits+=std::dynamic_pointer_cast<SvarObject>(values[i&7].value())!=nullptr;
+    }),n);
+
+    bench::report("isObject",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i&7].isObject();
+    }),n);
+
+    bench::report("classObject json (baseline)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i&7].classObject()._json_type==integer_t;
+    }),n);
+
+    bench::report("jsontype",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i&7].jsontype()==integer_t;
+    }),n);
+
+    bench::report("virtual as (baseline)",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i&7].value()->as(typeid(double))!=nullptr;
+    }),n);
+
+    bench::report("is<double>",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i&7].is<double>();
+    }),n);
+
+    bench::report("castAs<double>",bench::measure([&](){
+        for(int i=0;i<n;i++) hits+=values[i%3].castAs<double>()>0;
+    }),n);
+
+    std::cout<<"hits: "<<hits<<std::endl;
+    return 0;
+}
+
+REGISTER_SVAR_MODULE(bench_type_check){
+    svar["apps"]["bench_type_check"]={bench_type_check,"Benchmark the builtin type predicates"};
+}
@@ -48,3 +48,32 @@ TEST(Svar,Cast){
     printA(sptrvar);
 
 }
+
+TEST(Svar,TryCast){
+    int i=0;
+    EXPECT_TRUE(Svar(2.5).tryCast(i));
+    EXPECT_EQ(i,2);
+    EXPECT_TRUE(Svar((int64_t)7).tryCast(i));
+    EXPECT_EQ(i,7);
+    EXPECT_TRUE(Svar(std::string("12")).tryCast(i));
+    EXPECT_EQ(i,12);
+
+    std::vector<int> vec;
+    EXPECT_TRUE(Svar({1,2,3}).tryCast(vec));
+    EXPECT_EQ(vec.size(),3);
+
+    struct B{int b;};
+    B b={1};
+    B* ptr=nullptr;
+    EXPECT_TRUE(Svar(&b).tryCast(ptr));
+    EXPECT_EQ(ptr,&b);
+    EXPECT_FALSE(Svar(1).tryCast(ptr));
+    std::string str;
+    EXPECT_FALSE(Svar::object().tryCast(str));
+
+    Svar func=SvarFunction([](const B& rb){return rb.b;});
+    func.as<SvarFunction>().overload(SvarFunction([](std::string s){return -1;}));
+    EXPECT_EQ(func(b),1);
+    EXPECT_EQ(func(std::string("b")),-1);
+    EXPECT_THROW(func(Svar::object()),SvarExeption);
+}
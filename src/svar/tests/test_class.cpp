@@ -116,3 +116,108 @@ TEST(Class,Dynamic){
     auto p=Person("zhaoyong",10);
     EXPECT_NO_THROW(p.call("__str__"));
 }
+
+struct RegistryType{};
+
+TEST(Class,Registry){
+    std::vector<SvarClass*> classes(8,nullptr);
+    std::vector<std::thread> threads;
+    for(size_t i=0;i<classes.size();i++)
+        threads.push_back(std::thread([&classes,i](){
+            classes[i]=SvarClass::instance<RegistryType>();
+        }));
+    for(auto& t:threads) t.join();
+    for(SvarClass* cls:classes) EXPECT_EQ(cls,classes.front());
+
+    SvarClass& cls=*classes.front();
+    EXPECT_EQ(SvarClass::find(cls.id()),&cls);
+    EXPECT_EQ(cls.name(),"RegistryType");
+    EXPECT_EQ(cls._json_type,others_t);
+    EXPECT_EQ(SvarClass::Class<int>()._json_type,integer_t);
+
+    uint32_t id;
+    {
+        SvarClass dynamic("Dynamic");
+        id=dynamic.id();
+        EXPECT_EQ(SvarClass::find(id),&dynamic);
+    }
+    EXPECT_EQ(SvarClass::find(id),nullptr);
+
+    // the ids of destroyed classes are reused
+    uint32_t ids=detail::class_table::global().size();
+    for(int i=0;i<1000;i++) SvarClass temporary("Temporary");
+    EXPECT_LE(detail::class_table::global().size(),ids+1);
+}
+
+TEST(Class,Module){
+    Svar module=svar.import("sample_module");
+    ASSERT_FALSE(module.isUndefined());
+
+    // the module interned its keys and registered its classes in its own tables
+    EXPECT_EQ(module["add"](1,2),3);
+    EXPECT_TRUE(module.exist("Student"));
+    EXPECT_EQ(module.get<std::string>("__name__",""),"sample_module");
+
+    Svar student=module["Student"](10,"alice","nwpu");
+    EXPECT_EQ(student.call("getSchool"),"nwpu");
+    EXPECT_EQ(student.call("age"),10);// inherited from Person
+    EXPECT_EQ(student.get<std::string>("school",""),"nwpu");
+}
+
+struct TableBase{int value()const{return 1;}};
+struct TableDerived:public TableBase{};
+
+TEST(Class,MethodTable){
+    sv::Class<TableBase>("TableBase").def("value",&TableBase::value);
+    sv::Class<TableDerived>("TableDerived")
+            .inherit<TableBase>()
+            .def_static("__init__",[](){return TableDerived();});
+
+    Svar d=svar["TableDerived"]();
+    SvarClass& cls=d.classObject();
+    EXPECT_EQ(d.call("value"),1);
+
+    // probing does not write Undefined entries
+    size_t n=cls.attributes().length();
+    EXPECT_TRUE(cls["missing"].isUndefined());
+    EXPECT_THROW(d.call("missing"),SvarExeption);
+    EXPECT_EQ(cls.attributes().length(),n);
+
+    // methods defined on a parent later are found
+    static CallSite twice("twice");
+    EXPECT_THROW(twice(d),SvarExeption);
+    sv::Class<TableBase>().def("twice",[](TableBase& b){return 2*b.value();});
+    EXPECT_EQ(twice(d),2);
+    EXPECT_EQ(twice(d),2);
+    EXPECT_TRUE(cls["twice"].isFunction());
+
+    // a child method shadows the parent one and the call site follows
+    cls.def("twice",[](TableDerived&){return 3;});
+    EXPECT_EQ(twice(d),3);
+    EXPECT_EQ(twice(Svar(TableBase())),2);
+
+    static CallSite init("__init__");
+    EXPECT_TRUE(init(svar["TableDerived"]).is<TableDerived>());
+
+    // attributes set without def are seen as well
+    SvarClass::Class<TableBase>().setAttr("label",Svar("base"));
+    EXPECT_EQ(cls["label"],"base");
+}
+
+struct PickA{};
+struct PickB{};
+struct PickC:public PickA,public PickB{};
+
+TEST(Class,MethodFallback){
+    // when the method of one parent fails, the next parent defining it is tried
+    sv::Class<PickA>("PickA").def("pick",[](PickA&,int x){return x;});
+    sv::Class<PickB>("PickB").def("pick",[](PickB&,const std::string& s){return s;});
+    sv::Class<PickC>("PickC").inherit<PickA>().inherit<PickB>();
+
+    Svar c=Svar::create(PickC());
+    EXPECT_EQ(c.call("pick",1),1);
+    EXPECT_EQ(c.call("pick",std::string("b")),"b");
+    static CallSite pick("pick");
+    EXPECT_EQ(pick(c,std::string("b")),"b");
+    EXPECT_THROW(c.call("pick",Svar::object()),SvarExeption);
+}
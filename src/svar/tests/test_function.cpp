@@ -83,6 +83,186 @@ TEST(Function,Overload){
     EXPECT_EQ(kw_f(1,2,3),6);
 }
 
+struct OverloadA{};
+struct OverloadB{};
+
+TEST(Function,OverloadCache){
+    Svar f([](OverloadA&){return 1;});
+    f.overload([](OverloadB&){return 2;});
+    f.overload([](int x){
+        if(x<0) throw SvarExeption("negative");
+        return 3;
+    });
+    f.overload([](double x){return 4;});
+
+    for(int i=0;i<3;i++){
+        EXPECT_EQ(f(Svar::create(OverloadB())),2);
+        EXPECT_EQ(f(Svar::create(OverloadA())),1);
+        EXPECT_EQ(f(1),3);
+        EXPECT_EQ(f(-1),4);// the cached overload throws, later ones are tried
+    }
+    EXPECT_THROW(f(std::string("a"),1),SvarExeption);
+
+    f.overload([](const std::string& s,int x){return 5;});
+    EXPECT_EQ(f(std::string("a"),1),5);
+    EXPECT_EQ(f(1),3);
+
+    // whether an array converts depends on its items, the first match is kept for each call
+    Svar k([](std::vector<OverloadA>){return "foos";});
+    k.overload([](Svar){return "any";});
+    Svar foos({Svar::create(OverloadA()),Svar::create(OverloadA())});
+    for(int i=0;i<2;i++){
+        EXPECT_EQ(k(foos),"foos");
+        EXPECT_EQ(k(Svar({1})),"any");
+    }
+}
+
+TEST(Function,OverloadArguments){
+    // a converted argument is not seen by later overloads when a later argument fails
+    Svar g([](std::vector<int> v,OverloadA){return 1;});
+    g.overload([](Svar v,Svar x){return v.isArray();});
+    EXPECT_EQ(g(Svar({1,2}),2),true);
+
+    SvarArgs args;
+    args.push_back(Svar({1,2}));
+    Svar h([](std::vector<int> v){return (int)v.size();});
+    EXPECT_EQ(h.as<SvarFunction>().Call(args),2);
+    EXPECT_TRUE(args[0].isArray());
+}
+
+TEST(Function,ManyArguments){
+    // more arguments than SvarArgs keeps in place
+    Svar sum9([](int a,int b,int c,int d,int e,int f,int g,int h,int i){
+        return a+b+c+d+e+f+g+h+i;
+    });
+    EXPECT_EQ(sum9(1,2,3,4,5,6,7,8,9),45);
+
+    std::vector<Svar> argv={1,2,3,4,5,6,7,8,9};
+    EXPECT_EQ(sum9.as<SvarFunction>().Call(argv),45);
+
+    SvarArgs args={1,2};
+    for(int i=3;i<=9;i++) args.push_back(i);
+    args.insert(args.begin(),args[0]);
+    EXPECT_EQ(args.size(),10);
+    EXPECT_EQ(args[0],1);
+    EXPECT_EQ(args[9],9);
+    SvarArgs moved=std::move(args);
+    EXPECT_EQ(moved.size(),10);
+    EXPECT_TRUE(args.empty());
+
+    // the failing function and its callers are listed in the error
+    Svar inner([](int x){return x;});
+    Svar outer([inner](Svar x){return inner(x);});
+    try{
+        outer(Svar::object());
+        FAIL();
+    }
+    catch(SvarExeption& e){
+        EXPECT_NE(std::string(e.what()).find("Stack:"),std::string::npos);
+    }
+}
+
+TEST(Function,Typed){
+    Svar module;
+    module["add"]=[](int a,int b){return a+b;};
+    module["add"].overload([](double a,double b){return a*b;});
+    module["scale"]=[](double a,double b){return a*b;};
+
+    TypedFunction<int(int,int)> add=module["add"];
+    EXPECT_TRUE(add.isDirect());
+    EXPECT_EQ(add(1,2),3);
+
+    TypedFunction<double(double,double)> mul=module["add"];
+    EXPECT_TRUE(mul.isDirect());// the second overload
+    EXPECT_EQ(mul(2,3),6);
+
+    // no overload declared like this, converted through the generic path
+    TypedFunction<int(int,int)> scale=module["scale"];
+    EXPECT_FALSE(scale.isDirect());
+    EXPECT_EQ(scale(2,3),6);
+
+    int count=0;
+    TypedFunction<void(int)> inc=Svar([&count](int x){count+=x;});
+    inc(2);
+    TypedFunction<void(double)> inc_generic=Svar([&count](int x){count+=x;});
+    inc_generic(3);
+    EXPECT_EQ(count,5);
+
+    EXPECT_THROW(TypedFunction<int(int)>(Svar(1))(1),SvarExeption);
+}
+
+TEST(Function,Batch){
+    Svar square([](double x){return x*x;});
+    square.overload([](const std::string& s){return s+s;});
+    const SvarFunction& f=square.as<SvarFunction>();
+
+    // numbers are converted column-wise and looped, strings go through the generic path
+    Svar numbers=f.map({1,2.5,3});
+    EXPECT_TRUE(numbers.isArray());
+    EXPECT_EQ(numbers[1],6.25);
+    Svar mixed=f.map({"a",2});
+    EXPECT_EQ(mixed[0],"aa");
+    EXPECT_EQ(mixed[1],4.);
+
+    std::vector<double> values={1,2,3,4,5,6};
+    Svar buffer=SvarBuffer(values.data(),std::vector<ssize_t>({2,3}));
+    Svar squares=f.map(buffer,4);
+    const SvarBuffer& result=squares.as<SvarBuffer>();
+    EXPECT_EQ(result._format,"d");
+    EXPECT_EQ(result.shape,std::vector<ssize_t>({2,3}));
+    EXPECT_EQ(result.ptr<double>()[5],36);
+
+    Svar add([](int a,int b){return a+b;});
+    Svar sums=add.as<SvarFunction>().callBatch({Svar({1,2}),10});
+    EXPECT_EQ(sums[0],11);
+    EXPECT_EQ(sums[1],12);
+    EXPECT_THROW(add.as<SvarFunction>().callBatch({Svar({1,2}),Svar({1})}),SvarExeption);
+    EXPECT_THROW(add.as<SvarFunction>().callBatch({1,2}),SvarExeption);
+    EXPECT_THROW(add.as<SvarFunction>().callBatch({Svar({1,Svar::object()}),1}),SvarExeption);
+
+    // rows take the overload a call would take
+    Svar pick([](const std::string& s){return s;});
+    pick.overload([](double x){return x*2;});
+    Svar picked=pick.as<SvarFunction>().map({"a",1,2});
+    EXPECT_EQ(picked[0],pick("a"));
+    EXPECT_EQ(picked[1],pick(1));
+    EXPECT_EQ(picked[2],pick(2));
+    Svar rounded([](int x){return x;});
+    rounded.overload([](double x){return -x;});
+    Svar rows=rounded.as<SvarFunction>().map({1.5,2});
+    EXPECT_EQ(rows[0],rounded(1.5));
+    EXPECT_EQ(rows[1],rounded(2));
+}
+
+TEST(Function,Profile){
+    Svar module;
+    module.def("add",[](int a,int b){return a+b;});
+    module["add"].overload([](const SvarArray& a,const SvarArray& b){return a.length()+b.length();});
+    module.def("fail",[](){throw SvarExeption("failed");});
+
+    Svar builtin=Svar::instance()["__builtin__"];
+    SvarFunction::resetProfile();
+    builtin["profiling"](true);
+    module["add"](1,2);
+    module["add"](Svar::array(),Svar::array());// tries the int overload first
+    EXPECT_THROW(module["fail"](),SvarExeption);
+    builtin["profiling"](false);
+    module["add"](1,2);
+
+    Svar add,fail;
+    for(Svar f:builtin["profile"]()){
+        if(f["name"]=="add") add=f;
+        if(f["name"]=="fail") fail=f;
+    }
+    ASSERT_TRUE(add.isObject());
+    EXPECT_EQ(add["calls"],2);
+    EXPECT_EQ(add["misses"],1);
+    EXPECT_EQ(add["exceptions"],0);
+    EXPECT_GE(add["max_ns"].as<double>(),add["mean_ns"].as<double>());
+    ASSERT_TRUE(fail.isObject());
+    EXPECT_EQ(fail["exceptions"],1);
+}
+
 TEST(Function,KWARGS){
     Svar module;
     module.def("add",[](int a,int b){return a+b;},"a"_a,"b"_a=0,"Add two int");
@@ -92,4 +272,10 @@ TEST(Function,KWARGS){
     EXPECT_EQ(module["add"]("b"_a=2,"a"_a=3),5);
 
     EXPECT_THROW(module["add"]("b"_a=1),SvarExeption); // a is not defined
+    EXPECT_EQ(module["add"](1,"c"_a=2),1); // unknown keywords are ignored
+    EXPECT_EQ(module["add"](1,"b"_a=Svar()),1);
+
+    // binding for the first overload leaves the arguments of the next one untouched
+    module["add"].overload([](SvarObject&){return -1;});
+    EXPECT_EQ(module["add"](Svar::object()),-1);
 }
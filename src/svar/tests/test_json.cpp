@@ -1,5 +1,6 @@
 #include "Svar.h"
 #include "gtest.h"
+#include <set>
 
 using namespace sv;
 
@@ -32,6 +33,28 @@ TEST(JSON,Iterator){
     for(std::pair<std::string,Svar> it:obj) EXPECT_EQ(obj[it.first],it.second);
 }
 
+TEST(JSON,Views){
+    Svar var={1,2,3,4};
+    int sum=0;
+    for(const Svar& v:var.values()) sum+=v.as<int>();
+    EXPECT_EQ(sum,10);
+    EXPECT_EQ(var.values().size(),4);
+
+    Svar obj={{"a",1},{"b",2},{"c",3}};
+    std::set<std::string> keys;
+    for(const auto& it:obj.items(true)) keys.insert(it.first.str());
+    EXPECT_EQ(keys,std::set<std::string>({"a","b","c"}));
+    sum=0;
+    for(const Svar& v:obj.values(true)) sum+=v.as<int>();
+    EXPECT_EQ(sum,6);
+
+    for(const auto& it:obj.clone().items()) obj[it.first.str()+"2"]=it.second;
+    EXPECT_EQ(obj.length(),6);
+    EXPECT_EQ(obj.find("b2")==obj.end(),false);
+    EXPECT_TRUE(Svar(1).begin()==Svar(1).end());
+    EXPECT_THROW(Svar(1).items(),SvarExeption);
+}
+
 
 TEST(JSON,GetSet){
     Svar var;
@@ -143,3 +166,337 @@ TEST(JSON,unordered_map){
     std::unordered_map<std::string,double> um= {{"a",1},{"b",2}};
     sst<<Svar(um);
 }
+
+TEST(JSON,InternedKeys){
+    SvarKey a("a"),b("b");
+    EXPECT_EQ(a,SvarKey(std::string("a")));
+    EXPECT_NE(a,b);
+    EXPECT_EQ(&a.str(),&SvarKey("a").str());
+
+    Svar var=Svar::parse_json("{\"a\":1,\"b\":{\"a\":2}}");
+    for(auto& it:var.as<SvarObject>()._var)
+        EXPECT_TRUE(it.first==a||it.first==b);
+    EXPECT_EQ(var[a],1);
+    EXPECT_EQ(var[b][a],2);
+    EXPECT_EQ(var.get(a,0),1);
+
+    var.set(SvarKey("c"),3);
+    var[SvarKey("d")]=4;
+    EXPECT_EQ(var["c"],3);
+    EXPECT_EQ(var.get<int>("d",0),4);
+    EXPECT_EQ(Svar(a),"a");
+
+    // keys of loaded data stop being interned once the table is full
+    Svar ids=Svar::object();
+    size_t n=detail::key_table::max_atoms+16;
+    for(size_t i=0;i<n;i++) ids.set(SvarKey("id"+std::to_string(i)),(int)i);
+    EXPECT_LE(SvarKey::count(),(size_t)detail::key_table::max_atoms);
+    EXPECT_EQ(ids.get<int>(std::string("id")+std::to_string(n-1),0),(int)n-1);
+    EXPECT_EQ(ids[SvarKey("id0")],0);
+    EXPECT_EQ(a,SvarKey("a"));
+}
+
+TEST(JSON,ObjectStorage){
+    Svar obj=Svar::object();
+    Svar& first=obj["k0"];
+    for(int i=0;i<40;i++) obj["k"+std::to_string(i)]=i;
+    EXPECT_EQ(first,0);
+    EXPECT_EQ(obj.length(),40);
+
+    for(int i=0;i<40;i+=3) obj.erase("k"+std::to_string(i));
+    EXPECT_EQ(obj.length(),26);
+    EXPECT_FALSE(obj.exist("k3"));
+    EXPECT_EQ(obj["k4"],4);
+    EXPECT_EQ(obj["k38"],38);
+
+    obj["k3"]=-3;
+    obj["k39"]=-39;
+    int sum=0;
+    size_t count=0;
+    for(std::pair<std::string,Svar> it:obj){
+        EXPECT_EQ(obj[it.first],it.second);
+        sum+=it.second.as<int>();
+        count++;
+    }
+    EXPECT_EQ(count,obj.length());
+    EXPECT_EQ(obj.length(),28);
+    EXPECT_EQ(sum,465);
+
+    Svar copy=obj.clone(1);
+    copy["k4"]=44;
+    EXPECT_EQ(obj["k4"],4);
+    Svar parsed=Svar::parse_json(obj.dump_json());
+    EXPECT_EQ(parsed.length(),obj.length());
+    for(std::pair<std::string,Svar> it:obj) EXPECT_EQ(parsed[it.first],it.second);
+}
+
+struct DictKey{
+    int id;
+};
+
+struct EqualKey{
+    int id;
+};
+
+TEST(JSON,dict){
+    Svar dict=Svar::dict();
+    dict[1]="int";
+    dict["1"]="string";
+    dict[2.5]="double";
+    EXPECT_EQ(dict.length(),3);
+    EXPECT_EQ(dict[1.0],"int");
+    EXPECT_EQ(dict[true],"int");
+    EXPECT_EQ(dict["1"],"string");
+    EXPECT_EQ(dict[2.5],"double");
+    dict.erase(1);
+    EXPECT_EQ(dict.length(),2);
+
+    std::map<int,std::string> m={{1,"a"},{2,"b"}};
+    Svar var(m);
+    EXPECT_TRUE(var.isDict());
+    EXPECT_EQ((var.castAs<std::map<int,std::string>>()),m);
+
+    SvarClass::Class<DictKey>()
+            .def("__hash__",[](DictKey& self){return self.id;})
+            .def("__eq__",[](DictKey& self,DictKey& rh){return self.id==rh.id;});
+    Svar custom=Svar::dict();
+    custom[Svar::create(DictKey{1})]=1;
+    custom[Svar::create(DictKey{1})]=2;
+    custom[Svar::create(DictKey{2})]=3;
+    EXPECT_EQ(custom.length(),2);
+    EXPECT_EQ(custom[Svar::create(DictKey{1})],2);
+
+    // equal values must hash equal, so __eq__ without __hash__ is unhashable
+    SvarClass::Class<EqualKey>()
+            .def("__eq__",[](EqualKey& self,EqualKey& rh){return self.id==rh.id;});
+    EXPECT_THROW(custom[Svar::create(EqualKey{1})]=4,SvarExeption);
+}
+
+TEST(JSON,Clone){
+    Svar tree={{"a",{{"b",{1,2,{{"c",3}}}}}},{"d",4}};
+    Svar copy=tree.clone(10);
+    EXPECT_EQ(copy.dump_json(),tree.dump_json());
+
+    copy["a"]["b"][2]["c"]=30;
+    EXPECT_EQ(tree["a"]["b"][2]["c"],3);
+    EXPECT_EQ(copy["a"]["b"][2]["c"],30);
+
+    tree["a"]["e"]=5;
+    tree["a"]["b"].push_back(6);
+    EXPECT_FALSE(copy["a"].exist("e"));
+    EXPECT_EQ(copy["a"]["b"].length(),3);
+
+    Svar second=tree.clone(10);
+    Svar inner=tree["a"]["b"][2];
+    inner["f"]=7;
+    EXPECT_FALSE(second["a"]["b"][2].exist("f"));
+
+    Svar shallow=tree.clone(1);
+    EXPECT_EQ(shallow["a"]["b"].value(),tree["a"]["b"].value());
+    shallow["a"]["g"]=8;
+    EXPECT_FALSE(tree["a"].exist("g"));
+
+    Svar nested=copy.clone(10);
+    copy["d"]=40;
+    nested["a"]["b"][2]["c"]=300;
+    EXPECT_EQ(copy["a"]["b"][2]["c"],30);
+    EXPECT_EQ(nested["d"],4);
+    EXPECT_EQ(tree["a"]["b"][2]["c"],3);
+
+    // handles held into the original do not write into a clone made later
+    Svar& held=tree["a"]["b"][2]["c"];
+    Svar later=tree.clone(10);
+    held=2;
+    EXPECT_EQ(later["a"]["b"][2]["c"],3);
+}
+
+TEST(JSON,Int64){
+    Svar var=Svar::parse_json("[1,-2147483648,2147483648,1700000000123,-9223372036854775808,9223372036854775807,9223372036854775808]");
+    EXPECT_TRUE(var[0].is<int>());
+    EXPECT_TRUE(var[1].is<int>());
+    EXPECT_TRUE(var[2].is<int64_t>());
+    EXPECT_EQ(var[3].as<int64_t>(),1700000000123LL);
+    EXPECT_EQ(var[4].as<int64_t>(),std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(var[5].as<int64_t>(),std::numeric_limits<int64_t>::max());
+    EXPECT_TRUE(var[6].is<double>());
+    EXPECT_EQ(var[5].jsontype(),integer64_t);
+    EXPECT_EQ(Svar::parse_json(var.dump_json()).dump_json(),var.dump_json());
+    EXPECT_EQ(var[3].dump_json(),"1700000000123");
+
+    Svar big((int64_t)1700000000123LL);
+    EXPECT_EQ((big+Svar(1)).as<int64_t>(),1700000000124LL);
+    EXPECT_EQ((Svar(1)+big).as<int64_t>(),1700000000124LL);
+    EXPECT_EQ((Svar(2147483647)+Svar(1)).as<int64_t>(),2147483648LL);
+    EXPECT_EQ((Svar(65536)*Svar(65536)).as<int64_t>(),4294967296LL);
+    EXPECT_TRUE((Svar(2)*Svar(3)).is<int>());
+    EXPECT_EQ(big,var[3]);
+    EXPECT_EQ(Svar((int64_t)3).castAs<int>(),3);
+    EXPECT_EQ(Svar(3).castAs<int64_t>(),3);
+
+    Svar dict=Svar::dict();
+    dict[Svar((int64_t)5)]="five";
+    EXPECT_EQ(dict[5],"five");
+}
+
+TEST(JSON,View){
+    const char text[]="{\"a\":[1,2.5,\"x\\ny\",\"plain\",\"\\u00e9\"],\"b\":true,\"c\":-3e2}trailing";
+    size_t size=sizeof(text)-1-8;
+    Svar var=Json::load(text,size);
+    EXPECT_EQ(var["a"][0],1);
+    EXPECT_EQ(var["a"][1],2.5);
+    EXPECT_EQ(var["a"][2],"x\ny");
+    EXPECT_EQ(var["a"][3],"plain");
+    EXPECT_EQ(var["a"][4],"\xc3\xa9");
+    EXPECT_EQ(var["c"],-300.);
+
+    EXPECT_EQ(Json::load(SvarBuffer(text,size)).dump_json(),var.dump_json());
+    EXPECT_EQ(Svar::instance()["__builtin__"]["Json"].call("load",SvarBuffer(text,size)).dump_json(),
+              var.dump_json());
+
+    // numbers and literals ending exactly at the end of the view
+    const char number[]="12.75999";
+    EXPECT_EQ(Json::load(number,5),12.75);
+    EXPECT_EQ(Json::load(number,2),12);
+    EXPECT_EQ(Json::load("truex",4),true);
+    EXPECT_THROW(Json::load("\"abc\"",4),SvarExeption);
+    EXPECT_THROW(Json::load("[1,2]",4),SvarExeption);
+}
+
+TEST(JSON,Scan){
+    // strings, escapes and whitespace runs crossing the 16 and 32 byte blocks
+    std::string json="[";
+    for(int n=0;n<70;n++){
+        if(n) json+=",";
+        json+=std::string(n,n%2?' ':'\n')+"\""+std::string(n,'a')+(n%3?"\\t":"")+std::string(n%7,'b')+"\"";
+        json+=std::string(n%5,'\t')+","+std::to_string(n*0.25)+std::string(n,' ');
+    }
+    json+="]";
+
+    int best=detail::json_scan::level();
+    std::string expected;
+    for(int level=0;level<=best;level++){
+        detail::json_scan::level()=level;
+        Svar var=Json::load(json.data(),json.size());
+        ASSERT_EQ(var.length(),140);
+        EXPECT_EQ(var[2*68],std::string(68,'a')+"\t"+std::string(68%7,'b'));
+        EXPECT_EQ(var[2*69],std::string(69,'a')+std::string(69%7,'b'));
+        EXPECT_EQ(var[2*69+1],69*0.25);
+        if(level==0) expected=var.dump_json();
+        else EXPECT_EQ(var.dump_json(),expected);
+        EXPECT_THROW(Json::load(json.data(),json.size()-200),SvarExeption);
+    }
+    detail::json_scan::level()=best;
+}
+
+namespace {
+
+/// Records the events as text and skips the keys named "skip"
+class JsonRecorder : public Json::Handler{
+public:
+    std::string events;
+    int stopAt=-1;
+
+    Action add(const std::string& event,Action action=CONTINUE){
+        events+=event+" ";
+        return --stopAt==0?STOP:action;
+    }
+
+    Action startObject(){return add("{");}
+    Action key(const std::string& name){return add(name+":",name=="skip"?SKIP:CONTINUE);}
+    Action endObject(){return add("}");}
+    Action startArray(){return add("[");}
+    Action endArray(){return add("]");}
+    Action string(const std::string& value){return add("\""+value+"\"");}
+    Action integer(int64_t value){return add(std::to_string(value));}
+    Action number(double value){return add(std::to_string(value));}
+    Action boolean(bool value){return add(value?"true":"false");}
+    Action null(){return add("null");}
+};
+
+}
+
+TEST(JSON,Handler){
+    std::string json="{\"a\":[1,-2.5,\"x\\ny\",true,null,{}],\"skip\":{\"b\":[1,\"]}\\\"\",{}]},"
+                     "\"c\":9223372036854775807,\"skip\":\"s\",\"d\":false}";
+    JsonRecorder recorder;
+    EXPECT_TRUE(Json::parse(json,recorder));
+    EXPECT_EQ(recorder.events,"{ a: [ 1 -2.500000 \"x\ny\" true null { } ] skip: c: 9223372036854775807 skip: d: false } ");
+
+    JsonRecorder stopped;
+    stopped.stopAt=4;
+    EXPECT_FALSE(Json::parse(json,stopped));
+    EXPECT_EQ(stopped.events,"{ a: [ 1 ");
+
+    JsonRecorder broken;
+    EXPECT_THROW(Json::parse("{\"skip\":[1,2}",broken),SvarExeption);
+    EXPECT_THROW(Json::parse("{\"skip\":[1,2}}",broken),SvarExeption);
+    EXPECT_THROW(Json::parse("{\"skip\":{\"a\":[}]},\"b\":1}",broken),SvarExeption);
+    EXPECT_THROW(Json::parse("[1,2] 3",broken),SvarExeption);
+}
+
+TEST(JSON,Stream){
+    std::string json="{\"a\":[1,{\"b\":\"}]\\\"\"}],\"c\":\"\\u00e9\"}\n[2,3] \"str\\\\\" 42 -1.5e3\ntrue {}";
+    std::vector<std::string> expected={"{\"a\":[1,{\"b\":\"}]\\\"\"}],\"c\":\"\xc3\xa9\"}","[2,3]","\"str\\\\\"",
+                                       "42","-1500.0","true","{}"};
+    for(auto& e:expected) e=Json::load(e).dump_json();
+
+    // split in two at every position and byte by byte
+    for(size_t split=0;split<=json.size();split++){
+        std::vector<std::string> values;
+        Json::Stream stream([&values](const Svar& v){values.push_back(v.dump_json());});
+        if(split==json.size())
+            for(char c:json) stream.push(&c,1);
+        else{
+            stream.push(json.substr(0,split));
+            stream.push(json.substr(split));
+        }
+        stream.finish();
+        EXPECT_EQ(values,expected);
+        EXPECT_EQ(stream.pending(),0u);
+    }
+
+    std::vector<Svar> values;
+    Json::Stream stream([&values](const Svar& v){values.push_back(v);});
+    stream.push("[1,2");
+    EXPECT_EQ(stream.pending(),4u);
+    EXPECT_THROW(stream.finish(),SvarExeption);
+    EXPECT_THROW(stream.push("[1}"),SvarExeption);
+    stream.push("[3]");
+    EXPECT_EQ(values.size(),1u);
+    EXPECT_EQ(values[0][0],3);
+}
+
+TEST(JSON,Lines){
+    std::string lines;
+    for(int i=0;i<1000;i++){
+        lines+="{\"id\":"+std::to_string(i)+",\"tags\":[\"a\",\"b\"]}"+(i%3?"\n":"\r\n");
+        if(i%100==0) lines+="  \n";
+    }
+    lines.pop_back();
+
+    for(int threads:{1,4}){
+        Svar values=Json::loadLines(lines.data(),lines.size(),threads);
+        ASSERT_EQ(values.length(),1000);
+        for(int i=0;i<1000;i++) EXPECT_EQ(values[i]["id"],i);
+
+        std::vector<int> ids;
+        Json::loadLines(lines.data(),lines.size(),[&ids](const Svar& batch){
+            for(const Svar& v:batch.as<SvarArray>()._var) ids.push_back(v["id"].as<int>());
+        },threads,true,100);
+        ASSERT_EQ(ids.size(),1000u);
+        for(int i=0;i<1000;i++) EXPECT_EQ(ids[i],i);
+
+        ids.clear();
+        Json::loadLines(lines.data(),lines.size(),[&ids](const Svar& batch){
+            for(const Svar& v:batch.as<SvarArray>()._var) ids.push_back(v["id"].as<int>());
+        },threads,false,100);
+        std::sort(ids.begin(),ids.end());
+        ASSERT_EQ(ids.size(),1000u);
+        for(int i=0;i<1000;i++) EXPECT_EQ(ids[i],i);
+    }
+
+    EXPECT_EQ(Json::loadLines(SvarBuffer(lines.data(),lines.size())).length(),1000);
+    EXPECT_EQ(Json::loadLines("",0).length(),0);
+    std::string broken=lines+"\n{\"id\":}\n[1]";
+    EXPECT_THROW(Json::loadLines(broken.data(),broken.size(),4),SvarExeption);
+}
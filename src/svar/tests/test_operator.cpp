@@ -15,3 +15,41 @@ TEST(Svar,NumOp){
     EXPECT_EQ(Svar(5)|Svar(2),5|2);
     EXPECT_EQ(Svar(5)&Svar(2),5&2);
 }
+
+TEST(Svar,BuiltinOp){
+    int max=std::numeric_limits<int>::max();
+    EXPECT_TRUE((Svar(1)+Svar(2)).is<int>());
+    EXPECT_TRUE((Svar(max)+Svar(1)).is<int64_t>());
+    EXPECT_EQ((Svar(max)+Svar(1)).as<int64_t>(),(int64_t)max+1);
+    EXPECT_TRUE((Svar(1)+Svar((int64_t)2)).is<int64_t>());
+    EXPECT_TRUE((Svar((int64_t)1)*Svar(2.)).is<double>());
+    EXPECT_EQ(Svar(7)/Svar(2),3);
+    EXPECT_EQ(Svar((int64_t)7)%Svar(2),(int64_t)1);
+    EXPECT_THROW(Svar(7)%Svar((int64_t)2),SvarExeption);
+    EXPECT_THROW(Svar(1)+Svar("1"),SvarExeption);
+
+    // int64_t results that overflow become double, as int results become int64_t
+    int64_t max64=std::numeric_limits<int64_t>::max(),min64=std::numeric_limits<int64_t>::min();
+    EXPECT_TRUE((Svar(max64)+Svar(1)).is<double>());
+    EXPECT_TRUE((Svar(min64)-Svar(1)).is<double>());
+    EXPECT_TRUE((Svar(min64)*Svar(-1)).is<double>());
+    EXPECT_TRUE((Svar(min64)/Svar(-1)).is<double>());
+    EXPECT_EQ((Svar(max64)-Svar(1)).as<int64_t>(),max64-1);
+    EXPECT_EQ(Svar(min64)%Svar(-1),(int64_t)0);
+    EXPECT_TRUE((-Svar(min64)).is<double>());
+    EXPECT_TRUE((-Svar(std::numeric_limits<int>::min())).is<int64_t>());
+
+    EXPECT_TRUE(Svar(1)==Svar((int64_t)1));
+    EXPECT_TRUE(Svar(2.)==Svar(2));
+    EXPECT_TRUE(Svar(1.5)<Svar(2));
+    EXPECT_TRUE(Svar(true)==Svar(true));
+    EXPECT_TRUE(Svar("a")<Svar("b"));
+    EXPECT_EQ(Svar("a")+Svar("b"),"ab");
+
+    Svar arr={1,2};
+    EXPECT_EQ((arr+arr).length(),4);
+    EXPECT_EQ((arr*3).length(),6);
+    Svar obj=Svar::object({{"a",1}})+Svar::object({{"a",2},{"b",3}});
+    EXPECT_EQ(obj["a"],1);
+    EXPECT_EQ(obj["b"],3);
+}
@@ -36,3 +36,57 @@ TEST(Svar,Thread){
     svar.set("shouldstop",true);
     for(auto& it:threads) it.join();
 }
+
+TEST(Svar,PooledValues){
+    // values created in one thread and released in another go back to the pool
+    std::vector<Svar> values;
+    std::thread producer([&values](){
+        for(int i=0;i<10000;i++) values.push_back(Svar(i));
+    });
+    producer.join();
+
+    std::thread consumer([&values](){
+        for(int i=0;i<10000;i++) EXPECT_EQ(values[i].as<int>(),i);
+        values.clear();
+    });
+    consumer.join();
+
+    Svar s(std::string("pooled string"));
+    Svar copy=s;
+    copy=std::string("modified");
+    EXPECT_EQ(s.as<std::string>(),"modified");
+}
+
+TEST(Svar,Arena){
+    size_t regions=SvarArena::stats()["arena_regions"].castAs<int>();
+    Svar tree;
+    {
+        SvarArena arena(256);
+        tree=Svar::parse_json("{\"a\":[1,2.5,\"three\",{\"b\":true}],\"c\":null}");
+        EXPECT_EQ(SvarArena::stats()["arena_regions"].castAs<int>(),regions+1);
+        {
+            SvarArena inner;
+            Svar tmp=Svar::array({1,2,3});
+        }
+        tree["d"]=4;
+    }
+    EXPECT_EQ(tree["a"][3]["b"],true);
+    EXPECT_EQ(tree["d"],4);
+    EXPECT_EQ(SvarArena::stats()["arena_regions"].castAs<int>(),regions+1);
+
+    std::thread([&tree](){tree=Svar();}).join();
+    EXPECT_EQ(SvarArena::stats()["arena_regions"].castAs<int>(),regions);
+    EXPECT_TRUE(svar["__builtin__"]["memory"]().isObject());
+}
+
+TEST(Svar,PoolThreadExit){
+    // the blocks cached by a thread go back to the pool when it exits
+    auto churn=[](){
+        std::vector<Svar> values;
+        for(int i=0;i<10000;i++) values.push_back(Svar(i+0.5));
+    };
+    std::thread(churn).join();
+    int64_t bytes=SvarArena::stats()["pool_bytes"].castAs<int64_t>();
+    for(int i=0;i<20;i++) std::thread(churn).join();
+    EXPECT_EQ(SvarArena::stats()["pool_bytes"].castAs<int64_t>(),bytes);
+}